@@ -1,33 +1,71 @@
 set(headers
+    include/clustering/afkmc2.hpp
+    include/clustering/assignment_engine.hpp
+    include/clustering/blocked_assignment.hpp
+    include/clustering/bounded_assignment.hpp
     include/clustering/cluster_assignment_list.hpp
     include/clustering/clustering_result.hpp
+    include/clustering/distance_cache.hpp
+    include/clustering/fixed_dimension_assignment.hpp
+    include/clustering/kd_tree_assignment.hpp
     include/clustering/local_search.hpp
     include/clustering/kmeans.hpp
+    include/clustering/kmeans_parallel.hpp
+    include/clustering/kmeans_plus_plus.hpp
+    include/clustering/mini_batch_kmeans.hpp
+    include/clustering/out_of_core_kmeans.hpp
+    include/clustering/simd_assignment.hpp
+    include/clustering/sparse_assignment.hpp
+    include/clustering/yinyang_assignment.hpp
     include/coresets/coreset.hpp
     include/coresets/group_sampling.hpp
     include/coresets/sensitivity_sampling.hpp
     include/coresets/stream_km.hpp
+    include/coresets/weighted_matrix.hpp
+    include/data/block_file.hpp
     include/data/bow_parser.hpp
     include/data/census_parser.hpp
     include/data/covertype_parser.hpp
     include/data/data_parser.hpp
     include/data/tower_parser.hpp
+    include/utils/checkpoint.hpp
+    include/utils/logging.hpp
+    include/utils/parallel.hpp
     include/utils/random.hpp
 )
 
 set(sources
+    source/clustering/afkmc2.cpp
+    source/clustering/assignment_engine.cpp
+    source/clustering/blocked_assignment.cpp
+    source/clustering/bounded_assignment.cpp
     source/clustering/cluster_assignment_list.cpp
     source/clustering/clustering_result.cpp
+    source/clustering/distance_cache.cpp
+    source/clustering/fixed_dimension_assignment.cpp
+    source/clustering/kd_tree_assignment.cpp
     source/clustering/local_search.cpp
     source/clustering/kmeans.cpp
+    source/clustering/kmeans_parallel.cpp
+    source/clustering/kmeans_plus_plus.cpp
+    source/clustering/mini_batch_kmeans.cpp
+    source/clustering/out_of_core_kmeans.cpp
+    source/clustering/simd_assignment.cpp
+    source/clustering/sparse_assignment.cpp
+    source/clustering/yinyang_assignment.cpp
     source/coresets/coreset.cpp
     source/coresets/group_sampling.cpp
     source/coresets/sensitivity_sampling.cpp
     source/coresets/stream_km.cpp
+    source/coresets/weighted_matrix.cpp
+    source/data/block_file.cpp
     source/data/bow_parser.cpp
     source/data/census_parser.cpp
     source/data/covertype_parser.cpp
     source/data/tower_parser.cpp
+    source/utils/checkpoint.cpp
+    source/utils/logging.cpp
+    source/utils/parallel.cpp
     source/utils/random.cpp
 )
 
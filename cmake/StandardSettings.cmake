@@ -12,6 +12,14 @@ option(${PROJECT_NAME}_USE_ALT_NAMES "Use alternative names for the project, suc
 
 option(${PROJECT_NAME}_WARNINGS_AS_ERRORS "Treat compiler warnings as errors." OFF)
 
+#
+# Logging
+#
+# Messages below this level are removed at compile time: TRACE, DEBUG, INFO, WARNING, ERROR or OFF.
+
+set(${PROJECT_NAME}_LOG_LEVEL "INFO" CACHE STRING "The lowest level of the log messages compiled into the library.")
+set_property(CACHE ${PROJECT_NAME}_LOG_LEVEL PROPERTY STRINGS TRACE DEBUG INFO WARNING ERROR OFF)
+
 #
 # Package managers
 #
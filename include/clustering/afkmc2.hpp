@@ -0,0 +1,59 @@
+#pragma once
+
+#include <limits>
+#include <iostream>
+#include <vector>
+
+#include <blaze/Math.h>
+
+#include <utils/logging.hpp>
+#include <utils/parallel.hpp>
+#include <utils/random.hpp>
+
+namespace clustering
+{
+    /**
+     * The default length of the Markov chains used to pick each center with AFK-MC².
+     */
+    const size_t AFKMC2ChainLength = 200;
+
+    /**
+     * @brief Assumption-free k-MC² initialisation (Bachem et al., 2016).
+     *
+     * Approximates k-Means++ seeding with Markov chains. A single pass over the data builds the
+     * proposal distribution q(x) = 1/2 * d(x, c1)^2 / sum d(x', c1)^2 + 1/(2N) from the first center
+     * c1. Every other center is the final state of a Metropolis-Hastings chain of length m over
+     * points drawn from q, so picking the remaining centers costs O(m*K^2*D) regardless of N.
+     */
+    template <typename T>
+    class AFKMC2Initialiser
+    {
+    public:
+        /**
+         * @brief Creates a new instance of AFKMC2Initialiser.
+         * @param data A NxD data matrix containing N data points where each point has D dimensions. The matrix is not copied and must outlive the initialiser.
+         * @param numThreads The number of threads used to compute the proposal distribution.
+         * @param chainLength The length m of the Markov chain used to pick each center.
+         */
+        AFKMC2Initialiser(const blaze::DynamicMatrix<T> &data, size_t numThreads = 1, size_t chainLength = AFKMC2ChainLength);
+
+        /**
+         * @brief Picks `k` points as centers.
+         * @param k The number of centers to pick.
+         * @param random The random number generator used to pick the centers.
+         */
+        std::vector<size_t>
+        pickCenters(size_t k, utils::Random &random);
+
+    private:
+        const blaze::DynamicMatrix<T> &data;
+        const size_t NumThreads;
+        const size_t ChainLength;
+
+        /**
+         * @brief Computes the squared distance between a point and its closest center.
+         */
+        double
+        calcMinSquaredDistance(size_t pointIndex, const std::vector<size_t> &centers) const;
+    };
+}
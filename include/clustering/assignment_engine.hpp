@@ -0,0 +1,131 @@
+#pragma once
+
+#include <memory>
+#include <iostream>
+
+#include <blaze/Math.h>
+
+#include <clustering/cluster_assignment_list.hpp>
+
+namespace clustering
+{
+    /**
+     * @brief The strategies available for the assignment step of Lloyd's algorithm.
+     */
+    enum class AssignmentMode
+    {
+        /**
+         * Compute the distance between every point and every center in each iteration.
+         */
+        Standard,
+
+        /**
+         * Elkan's algorithm: keeps one upper bound and k lower bounds per point.
+         */
+        Elkan,
+
+        /**
+         * Hamerly's algorithm: keeps one upper bound and a single lower bound per point.
+         */
+        Hamerly,
+
+        /**
+         * Yinyang k-Means: groups the centers and keeps one lower bound per group and point.
+         */
+        Yinyang,
+
+        /**
+         * Kanungo's filtering algorithm: assigns whole cells of a kd-tree over the points at once. Best for low dimensions.
+         */
+        KdTree
+    };
+
+    /**
+     * @brief Represents the assignment step of Lloyd's algorithm.
+     *
+     * An engine is used for a single run of Lloyd's algorithm and may keep state between
+     * consecutive calls to `assign` e.g., distance bounds that depend on the previous centers.
+     * Distances are computed in the scalar type `T` of the data.
+     */
+    template <typename T>
+    class IAssignmentEngine
+    {
+    public:
+        virtual ~IAssignmentEngine() {}
+
+        /**
+         * @brief Assigns every point to its closest center.
+         * @param data A NxD data matrix containing N data points where each point has D dimensions.
+         * @param centers A KxD matrix containing the current centers.
+         * @param assignments The cluster assignments to update.
+         */
+        virtual void
+        assign(const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<T> &centers, ClusterAssignmentList &assignments) = 0;
+
+        /**
+         * @brief Makes sure that the cost of each point in `assignments` is the exact distance to the
+         * center it was assigned to in the last call to `assign` rather than an upper bound.
+         */
+        virtual void
+        finalise(const blaze::DynamicMatrix<T> &data, ClusterAssignmentList &assignments) = 0;
+
+        /**
+         * @brief Gets the sum and the number of the points assigned to each center in the last call to `assign`.
+         *
+         * Engines which summarise groups of points can provide the sums without visiting every point.
+         *
+         * @param sums A KxD matrix which receives the sum of the points assigned to each center.
+         * @param counts Receives the number of points assigned to each center.
+         * @return False if the engine does not keep the sums, in which case they have to be computed from the assignments.
+         */
+        virtual bool
+        getCentroidSums(blaze::DynamicMatrix<double> &/*sums*/, blaze::DynamicVector<size_t> &/*counts*/) const
+        {
+            return false;
+        }
+    };
+
+    /**
+     * @brief Assignment engine which computes all N*K point-to-center distances.
+     *
+     * Distances are computed with the blocked matrix multiplication kernel. The squared norms of
+     * the data points are computed on the first call and reused since the data does not change.
+     */
+    template <typename T>
+    class StandardAssignmentEngine : public IAssignmentEngine<T>
+    {
+    public:
+        /**
+         * @brief Creates a new instance of StandardAssignmentEngine.
+         * @param numThreads The number of threads used to assign points.
+         * @param dataSquaredNorms The squared norms of the data points if they are shared with other engines, otherwise they are computed on the first call.
+         */
+        StandardAssignmentEngine(size_t numThreads = 1, std::shared_ptr<const blaze::DynamicVector<T>> dataSquaredNorms = nullptr);
+
+        void
+        assign(const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<T> &centers, ClusterAssignmentList &assignments);
+
+        void
+        finalise(const blaze::DynamicMatrix<T> &data, ClusterAssignmentList &assignments);
+
+    private:
+        const size_t NumThreads;
+
+        /**
+         * The squared L2 norm of each data point: ||x||^2
+         */
+        std::shared_ptr<const blaze::DynamicVector<T>> dataSquaredNorms;
+    };
+
+    /**
+     * @brief Creates the assignment engine for the given mode.
+     * @param mode The assignment strategy.
+     * @param numOfPoints The number of points in the dataset.
+     * @param numOfClusters The number of centers.
+     * @param numThreads The number of threads used to assign points. Zero means one per hardware core.
+     * @param dataSquaredNorms Optional squared norms of the data points shared by several engines over the same data.
+     */
+    template <typename T>
+    std::shared_ptr<IAssignmentEngine<T>>
+    createAssignmentEngine(AssignmentMode mode, size_t numOfPoints, size_t numOfClusters, size_t numThreads = 1, std::shared_ptr<const blaze::DynamicVector<T>> dataSquaredNorms = nullptr);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <blaze/Math.h>
+
+#include <clustering/cluster_assignment_list.hpp>
+
+namespace clustering
+{
+    /**
+     * The number of points in a tile of the blocked assignment kernel.
+     */
+    const size_t AssignmentTilePoints = 128;
+
+    /**
+     * The number of centers in a tile of the blocked assignment kernel. Together with
+     * `AssignmentTilePoints` this keeps the tile of dot products (256 KiB) in the L2 cache.
+     */
+    const size_t AssignmentTileCenters = 256;
+
+    /**
+     * @brief Computes the squared L2 norm of each row in the matrix i.e., ||x||^2.
+     */
+    template <typename T>
+    blaze::DynamicVector<T>
+    calcSquaredRowNorms(const blaze::DynamicMatrix<T> &matrix);
+
+    /**
+     * @brief Assigns points to their closest centers using the expansion ||x - c||^2 = ||x||^2 - 2x·c + ||c||^2.
+     *
+     * The dot products are computed with a matrix multiplication (BLAS when available) on tiles of
+     * points by centers, and the closest center is found per row of each tile. Only the distance to
+     * the closest center is square rooted. Distances are computed in the scalar type `T` of the data
+     * while the costs in `assignments` are stored in double precision.
+     *
+     * @param data A NxD data matrix containing N data points where each point has D dimensions.
+     * @param dataSquaredNorms The squared norms of the rows in `data`, see `calcSquaredRowNorms`.
+     * @param centers A KxD matrix containing the centers.
+     * @param assignments The cluster assignments to update.
+     * @param beginPoint The first point to assign.
+     * @param endPoint One past the last point to assign.
+     */
+    template <typename T>
+    void
+    assignClosestCentersBlocked(const blaze::DynamicMatrix<T> &data, const blaze::DynamicVector<T> &dataSquaredNorms,
+                                const blaze::DynamicMatrix<T> &centers, ClusterAssignmentList &assignments,
+                                size_t beginPoint, size_t endPoint);
+}
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <blaze/Math.h>
+
+#include <clustering/assignment_engine.hpp>
+#include <clustering/cluster_assignment_list.hpp>
+#include <utils/parallel.hpp>
+
+namespace clustering
+{
+    /**
+     * @brief Base class for assignment engines which use the triangle inequality to skip
+     * point-to-center distance computations that cannot change the assignment of a point.
+     *
+     * The engine tracks an upper bound u(p) on the distance between each point and its assigned
+     * center. After the centers move, bounds are loosened by how far the centers moved, which
+     * is cheaper than recomputing the distances.
+     *
+     * Points are processed independently given the per-iteration state computed by `prepare`,
+     * so the engine splits the points over row ranges which are processed on multiple threads.
+     * Distances are computed in the scalar type `T` of the data while bounds are kept in double.
+     */
+    template <typename T>
+    class BoundedAssignmentEngine : public IAssignmentEngine<T>
+    {
+    public:
+        BoundedAssignmentEngine(size_t numOfPoints, size_t numOfClusters, size_t numThreads);
+
+        void
+        assign(const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<T> &centers, ClusterAssignmentList &assignments);
+
+        void
+        finalise(const blaze::DynamicMatrix<T> &data, ClusterAssignmentList &assignments);
+
+    protected:
+        const size_t NumOfPoints;
+        const size_t NumOfClusters;
+        const size_t NumThreads;
+
+        /**
+         * Whether the bounds have been initialised by a previous call to `assign`.
+         */
+        bool isInitialised;
+
+        /**
+         * The centers used in the previous call to `assign`.
+         */
+        blaze::DynamicMatrix<T> previousCenters;
+
+        /**
+         * The distance each center moved since the previous call to `assign`: δ(c)
+         */
+        blaze::DynamicVector<double> centerShifts;
+
+        /**
+         * Pairwise distances between the current centers: d(c, c'). Only computed by engines which need it.
+         */
+        blaze::DynamicMatrix<double> centerDistances;
+
+        /**
+         * Half the distance from each center to its closest other center: s(c)
+         */
+        blaze::DynamicVector<double> halfClosestCenterDistances;
+
+        /**
+         * Upper bound on the distance between each point and its assigned center: u(p)
+         */
+        blaze::DynamicVector<double> upperBounds;
+
+        /**
+         * Whether u(p) is known to be the exact distance.
+         */
+        blaze::DynamicVector<bool> upperBoundIsTight;
+
+        /**
+         * Computes the state that is shared by all points in an assignment step e.g., distances
+         * between centers. Called before the points are assigned.
+         */
+        virtual void
+        prepare(const blaze::DynamicMatrix<T> &centers) = 0;
+
+        /**
+         * Performs the first assignment of points [beginPoint, endPoint) where all distances are computed and bounds are initialised.
+         */
+        virtual void
+        initialiseBounds(const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<T> &centers, ClusterAssignmentList &assignments, size_t beginPoint, size_t endPoint) = 0;
+
+        /**
+         * Loosens the bounds of points [beginPoint, endPoint) based on `centerShifts` and reassigns points whose bounds overlap.
+         */
+        virtual void
+        updateAssignments(const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<T> &centers, ClusterAssignmentList &assignments, size_t beginPoint, size_t endPoint) = 0;
+
+        /**
+         * Computes `centerDistances` and `halfClosestCenterDistances` for the given centers.
+         */
+        void
+        computeCenterDistances(const blaze::DynamicMatrix<T> &centers);
+
+        /**
+         * Computes the L2 distance between point `p` and center `c`.
+         */
+        double
+        distance(const blaze::DynamicMatrix<T> &data, size_t p, const blaze::DynamicMatrix<T> &centers, size_t c) const
+        {
+            return static_cast<double>(blaze::norm(blaze::row(data, p) - blaze::row(centers, c)));
+        }
+
+    };
+
+    /**
+     * @brief Elkan's accelerated k-Means assignment step.
+     *
+     * Keeps k lower bounds per point so it prunes the most distance computations,
+     * but it requires O(N*K) memory.
+     */
+    template <typename T>
+    class ElkanAssignmentEngine : public BoundedAssignmentEngine<T>
+    {
+    public:
+        ElkanAssignmentEngine(size_t numOfPoints, size_t numOfClusters, size_t numThreads = 1);
+
+    protected:
+        using BoundedAssignmentEngine<T>::NumOfClusters;
+        using BoundedAssignmentEngine<T>::isInitialised;
+        using BoundedAssignmentEngine<T>::centerShifts;
+        using BoundedAssignmentEngine<T>::centerDistances;
+        using BoundedAssignmentEngine<T>::halfClosestCenterDistances;
+        using BoundedAssignmentEngine<T>::upperBounds;
+        using BoundedAssignmentEngine<T>::upperBoundIsTight;
+        using BoundedAssignmentEngine<T>::computeCenterDistances;
+        using BoundedAssignmentEngine<T>::distance;
+
+        void
+        prepare(const blaze::DynamicMatrix<T> &centers);
+
+        void
+        initialiseBounds(const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<T> &centers, ClusterAssignmentList &assignments, size_t beginPoint, size_t endPoint);
+
+        void
+        updateAssignments(const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<T> &centers, ClusterAssignmentList &assignments, size_t beginPoint, size_t endPoint);
+
+    private:
+        /**
+         * Lower bound on the distance between each point and each center: l(p, c)
+         */
+        blaze::DynamicMatrix<double> lowerBounds;
+    };
+
+    /**
+     * @brief Hamerly's accelerated k-Means assignment step.
+     *
+     * Keeps a single lower bound per point on the distance to its second closest center
+     * which makes it use O(N) memory. Works best for low-dimensional data and small k.
+     */
+    template <typename T>
+    class HamerlyAssignmentEngine : public BoundedAssignmentEngine<T>
+    {
+    public:
+        HamerlyAssignmentEngine(size_t numOfPoints, size_t numOfClusters, size_t numThreads = 1);
+
+    protected:
+        using BoundedAssignmentEngine<T>::NumOfClusters;
+        using BoundedAssignmentEngine<T>::isInitialised;
+        using BoundedAssignmentEngine<T>::centerShifts;
+        using BoundedAssignmentEngine<T>::centerDistances;
+        using BoundedAssignmentEngine<T>::halfClosestCenterDistances;
+        using BoundedAssignmentEngine<T>::upperBounds;
+        using BoundedAssignmentEngine<T>::upperBoundIsTight;
+        using BoundedAssignmentEngine<T>::computeCenterDistances;
+        using BoundedAssignmentEngine<T>::distance;
+
+        void
+        prepare(const blaze::DynamicMatrix<T> &centers);
+
+        void
+        initialiseBounds(const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<T> &centers, ClusterAssignmentList &assignments, size_t beginPoint, size_t endPoint);
+
+        void
+        updateAssignments(const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<T> &centers, ClusterAssignmentList &assignments, size_t beginPoint, size_t endPoint);
+
+    private:
+        /**
+         * Lower bound on the distance between each point and its second closest center: l(p)
+         */
+        blaze::DynamicVector<double> lowerBounds;
+
+        /**
+         * The center which moved the most and the two largest center shifts.
+         */
+        size_t largestShiftCluster;
+        double largestShift;
+        double secondLargestShift;
+
+        /**
+         * Finds the closest and the second closest centers of point `p` and updates its bounds.
+         */
+        void
+        assignToClosestCenter(const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<T> &centers, ClusterAssignmentList &assignments, size_t p);
+    };
+}
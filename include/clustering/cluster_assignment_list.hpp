@@ -1,16 +1,28 @@
 #pragma once
 
+#include <stdexcept>
 #include <string>
 #include <iostream>
+#include <vector>
 
 #include <blaze/Math.h>
 #include <boost/array.hpp>
 #include <boost/range/algorithm_ext/erase.hpp>
 
+#include <utils/checkpoint.hpp>
+
 namespace clustering
 {
+    template <typename T>
+    class IAssignmentEngine;
+
+    template <typename T>
+    class PairwiseDistanceCache;
+
     /**
      * @brief Represents a collection of points-to-cluster assignments.
+     *
+     * The data may be stored in single or double precision, the costs are always kept in double precision.
      */
     class ClusterAssignmentList
     {
@@ -38,8 +50,38 @@ namespace clustering
         /**
          * @brief Assign all data points to their closest centers.
          */
+        template <typename T>
+        void
+        assignAll(const blaze::DynamicMatrix<T> &dataPoints, const blaze::DynamicMatrix<T> &centers);
+
+        /**
+         * @brief Assign all sparse data points to their closest centers using sparse dot products.
+         */
+        template <typename T>
         void
-        assignAll(const blaze::DynamicMatrix<double> &dataPoints, const blaze::DynamicMatrix<double> &centers);
+        assignAll(const blaze::CompressedMatrix<T> &dataPoints, const blaze::DynamicMatrix<T> &centers);
+
+        /**
+         * @brief Assign all data points to their closest centers using the given assignment engine.
+         *
+         * Reusing the same engine across calls lets it skip the points whose assignment cannot
+         * change since the previous call, e.g., when only a few centers are replaced.
+         */
+        template <typename T>
+        void
+        assignAll(const blaze::DynamicMatrix<T> &dataPoints, const blaze::DynamicMatrix<T> &centers, IAssignmentEngine<T> &engine);
+
+        /**
+         * @brief Assign all data points to their closest centers when every center is a data point.
+         *
+         * The distances are looked up in the cache, so no distance is computed for cached rows.
+         *
+         * @param distanceCache Cache of pairwise distances between the data points.
+         * @param centerPoints The index of the data point used as each center.
+         */
+        template <typename T>
+        void
+        assignAll(PairwiseDistanceCache<T> &distanceCache, const std::vector<size_t> &centerPoints);
 
         /**
          * @brief Assign a point to a cluster.
@@ -81,6 +123,30 @@ namespace clustering
         size_t
         countPointsInCluster(size_t clusterIndex) const;
 
+        /**
+         * @brief Sets the weight of each point, e.g., the weights of the points of a coreset.
+         *
+         * The total cost, the cluster costs and the normalized costs of weighted assignments sum up
+         * w(p) * cost(p, A) while `getPointCost` still returns the unweighted cost. An empty vector
+         * removes the weights.
+         *
+         * @throws std::invalid_argument if the number of weights is not the number of points.
+         */
+        void
+        setPointWeights(const blaze::DynamicVector<double> &weights);
+
+        /**
+         * @brief Returns whether the points have weights.
+         */
+        bool
+        hasPointWeights() const;
+
+        /**
+         * @brief Returns the weight of a point, which is one if the points have no weights.
+         */
+        double
+        getPointWeight(size_t pointIndex) const;
+
         /**
          * @brief Returns the total cost of the cluster assignments. 
          * 
@@ -98,7 +164,9 @@ namespace clustering
         getPointCost(size_t pointIndex) const;
 
         /**
-         * @brief Returns the average costs of each cluster.
+         * @brief Returns the average costs of each cluster, weighted by the point weights if there are any.
+         *
+         * The average cost of a cluster without points, or whose points all have zero weight, is zero.
          */
         std::shared_ptr<blaze::DynamicVector<double>>
         calcAverageClusterCosts() const;
@@ -115,6 +183,19 @@ namespace clustering
         blaze::DynamicVector<double>
         getNormalizedCosts() const;
 
+        /**
+         * @brief Stores the assignments in a checkpoint under the given name.
+         */
+        void
+        saveTo(utils::Checkpoint &checkpoint, const std::string &name) const;
+
+        /**
+         * @brief Restores the assignments stored in a checkpoint with `saveTo`.
+         * @throws std::invalid_argument if the checkpoint has a different number of points or clusters which do not exist.
+         */
+        void
+        loadFrom(const utils::Checkpoint &checkpoint, const std::string &name);
+
     private:
         /**
          * The total number of points in the dataset.
@@ -136,6 +217,11 @@ namespace clustering
          * assigned cluster of each point in the dataset.
          */
         blaze::DynamicVector<double> distances;
+
+        /**
+         * The weight of each point, or an empty vector if all points have unit weights.
+         */
+        blaze::DynamicVector<double> weights;
     };
 
 }
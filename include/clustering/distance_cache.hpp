@@ -0,0 +1,120 @@
+#pragma once
+
+#include <algorithm>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include <blaze/Math.h>
+
+#include <clustering/blocked_assignment.hpp>
+
+namespace clustering
+{
+    /**
+     * The default memory budget of the pairwise distance cache (1 GiB).
+     */
+    const size_t DefaultDistanceCacheBudget = 1UL << 30;
+
+    /**
+     * @brief A row of squared distances between one point and all points, held by the distance cache.
+     *
+     * The row stays valid even if the cache evicts it.
+     */
+    template <typename T>
+    class CachedDistanceRow
+    {
+    public:
+        CachedDistanceRow(std::shared_ptr<const blaze::DynamicVector<T>> distances);
+
+        /**
+         * @brief Returns the squared distance to the point with the given index.
+         */
+        T
+        operator[](size_t pointIndex) const
+        {
+            return (*distances)[pointIndex];
+        }
+
+        /**
+         * @brief Returns the number of points in the row.
+         */
+        size_t
+        size() const;
+
+    private:
+        std::shared_ptr<const blaze::DynamicVector<T>> distances;
+    };
+
+    /**
+     * @brief Memory-bounded cache of squared pairwise distances between the points of a dataset.
+     *
+     * Instead of materialising the full NxN distance matrix, the row of a point is computed on demand
+     * with a matrix-vector product, ||x - y||^2 = ||x||^2 - 2x·y + ||y||^2. The seeding and the local
+     * search ask for one row per center, so only the requested row is computed. The most recently used
+     * rows are kept as long as they fit in the memory budget, the least recently used rows are evicted
+     * first. Rows handed out stay alive, so holding many rows at the same time can temporarily exceed
+     * the budget. Distances are computed and stored in the scalar type `T` of the data.
+     *
+     * Rows are computed outside of the lock, so threads asking for different rows do not wait for each
+     * other. Threads asking for a row which is being computed wait for it instead of computing it again.
+     */
+    template <typename T>
+    class PairwiseDistanceCache
+    {
+    public:
+        /**
+         * @brief Creates a new instance of PairwiseDistanceCache.
+         * @param data A NxD data matrix containing N data points where each point has D dimensions. The matrix is not copied and must outlive the cache.
+         * @param memoryBudget The maximum number of bytes used by cached rows.
+         */
+        PairwiseDistanceCache(const blaze::DynamicMatrix<T> &data, size_t memoryBudget = DefaultDistanceCacheBudget);
+
+        /**
+         * @brief Returns the squared distances between a point and all points in the dataset.
+         * @param pointIndex The index of the point.
+         */
+        CachedDistanceRow<T>
+        getRow(size_t pointIndex);
+
+        /**
+         * @brief Returns the squared distance between two points.
+         */
+        T
+        getSquaredDistance(size_t p1, size_t p2);
+
+        /**
+         * @brief Returns the number of points in the dataset.
+         */
+        size_t
+        size() const;
+
+    private:
+        using RowPointer = std::shared_ptr<const blaze::DynamicVector<T>>;
+
+        const blaze::DynamicMatrix<T> &data;
+        const size_t MaxCachedRows;
+
+        blaze::DynamicVector<T> dataSquaredNorms;
+
+        /**
+         * Cached point indices, the most recently used row first.
+         */
+        std::list<size_t> recentlyUsedRows;
+
+        /**
+         * The cached rows by point index. A row which is still being computed is ready once its future is.
+         */
+        std::unordered_map<size_t, std::pair<std::shared_future<RowPointer>, std::list<size_t>::iterator>> cachedRows;
+
+        std::mutex cacheMutex;
+
+        /**
+         * @brief Computes the squared distances between a point and all points.
+         */
+        RowPointer
+        computeRow(size_t pointIndex) const;
+    };
+}
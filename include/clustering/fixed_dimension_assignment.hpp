@@ -0,0 +1,102 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <blaze/Math.h>
+
+#include <clustering/cluster_assignment_list.hpp>
+
+namespace clustering
+{
+    /**
+     * The largest number of dimensions for which a kernel specialised on the dimension is compiled.
+     */
+    const size_t MaxFixedDimension = 16;
+
+    /**
+     * @brief Whether `assignClosestCentersFixedDimension` has a kernel for data with `numOfDimensions` columns.
+     */
+    inline bool
+    isFixedDimensionSupported(size_t numOfDimensions)
+    {
+        return numOfDimensions >= 1 && numOfDimensions <= MaxFixedDimension;
+    }
+
+    /**
+     * @brief Assigns points to their closest centers for data with exactly `D` dimensions.
+     *
+     * The centers are packed into fixed size arrays and each point is loaded into registers once, so
+     * the distance loops have a compile-time trip count and are fully unrolled. For small D this is
+     * much cheaper than the matrix multiplication of `assignClosestCentersBlocked`, and the distances
+     * are computed directly which also avoids the cancellation of the norm expansion.
+     *
+     * @param data A NxD data matrix containing N data points where each point has D dimensions.
+     * @param centers A KxD matrix containing the centers.
+     * @param assignments The cluster assignments to update.
+     * @param beginPoint The first point to assign.
+     * @param endPoint One past the last point to assign.
+     */
+    template <size_t D, typename T>
+    void
+    assignClosestCentersFixed(const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<T> &centers,
+                              ClusterAssignmentList &assignments, size_t beginPoint, size_t endPoint)
+    {
+        const size_t k = centers.rows();
+
+        std::vector<std::array<T, D>> packedCenters(k);
+        for (size_t c = 0; c < k; c++)
+        {
+            for (size_t j = 0; j < D; j++)
+            {
+                packedCenters[c][j] = centers(c, j);
+            }
+        }
+
+        std::array<T, D> point;
+        for (size_t p = beginPoint; p < endPoint; p++)
+        {
+            for (size_t j = 0; j < D; j++)
+            {
+                point[j] = data(p, j);
+            }
+
+            T bestDistance = std::numeric_limits<T>::max();
+            size_t bestCluster = 0;
+
+            for (size_t c = 0; c < k; c++)
+            {
+                const auto &center = packedCenters[c];
+
+                T distance = T(0);
+                for (size_t j = 0; j < D; j++)
+                {
+                    const T diff = point[j] - center[j];
+                    distance += diff * diff;
+                }
+
+                if (distance < bestDistance)
+                {
+                    bestDistance = distance;
+                    bestCluster = c;
+                }
+            }
+
+            assignments.assign(p, bestCluster, std::sqrt(static_cast<double>(bestDistance)));
+        }
+    }
+
+    /**
+     * @brief Assigns points to their closest centers with the kernel specialised on `data.columns()`.
+     * @return False, without touching `assignments`, if there is no kernel for the number of dimensions
+     *         in which case the caller should fall back to `assignClosestCentersBlocked`.
+     */
+    template <typename T>
+    bool
+    assignClosestCentersFixedDimension(const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<T> &centers,
+                                       ClusterAssignmentList &assignments, size_t beginPoint, size_t endPoint);
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include <blaze/Math.h>
+
+#include <clustering/assignment_engine.hpp>
+#include <clustering/cluster_assignment_list.hpp>
+#include <utils/parallel.hpp>
+
+namespace clustering
+{
+    /**
+     * The maximum number of points in a leaf of the kd-tree.
+     */
+    const size_t KdTreeLeafSize = 32;
+
+    /**
+     * The maximum number of subtrees which are filtered independently, possibly on separate threads.
+     */
+    const size_t KdTreeMaxSubtrees = 64;
+
+    /**
+     * @brief Kanungo et al.'s filtering algorithm for the assignment step of Lloyd's algorithm.
+     *
+     * A kd-tree is built once over the points and each node stores the bounding box, the sum and
+     * the number of its points. The tree is traversed with a set of candidate centers which is
+     * pruned at each node: a candidate is dropped when it is farther than the center closest to
+     * the cell from every point of the cell. When a single candidate is left, the whole subtree is
+     * assigned to it and its sum is added to the centroid sums without visiting the points, see
+     * `getCentroidSums`. This works best for low-dimensional data with many points per center.
+     *
+     * The costs of points assigned with their subtree are only computed by `finalise`.
+     */
+    template <typename T>
+    class KdTreeAssignmentEngine : public IAssignmentEngine<T>
+    {
+    public:
+        /**
+         * @brief Creates a new instance of KdTreeAssignmentEngine.
+         * @param numOfClusters The number of centers.
+         * @param numThreads The number of threads used to traverse the tree.
+         * @param leafSize The maximum number of points in a leaf of the tree.
+         */
+        KdTreeAssignmentEngine(size_t numOfClusters, size_t numThreads = 1, size_t leafSize = KdTreeLeafSize);
+
+        void
+        assign(const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<T> &centers, ClusterAssignmentList &assignments);
+
+        void
+        finalise(const blaze::DynamicMatrix<T> &data, ClusterAssignmentList &assignments);
+
+        bool
+        getCentroidSums(blaze::DynamicMatrix<double> &sums, blaze::DynamicVector<size_t> &counts) const;
+
+    private:
+        /**
+         * A node covers the points `pointIndices[beginPoint, endPoint)`. Leaves have no children.
+         */
+        struct Node
+        {
+            size_t beginPoint;
+            size_t endPoint;
+            size_t leftChild;
+            size_t rightChild;
+            bool isLeaf;
+        };
+
+        /**
+         * The state of the traversal of a single subtree.
+         */
+        struct SubtreeState
+        {
+            blaze::DynamicMatrix<double> sums;
+            blaze::DynamicVector<size_t> counts;
+
+            /**
+             * The candidate centers of the node at each depth of the traversal. Sized to the depth
+             * of the tree up front since the traversal keeps references into it.
+             */
+            std::vector<std::vector<size_t>> candidates;
+        };
+
+        const size_t NumOfClusters;
+        const size_t NumThreads;
+        const size_t LeafSize;
+
+        /**
+         * The indices of the points ordered such that each node covers a contiguous range.
+         */
+        std::vector<size_t> pointIndices;
+
+        std::vector<Node> nodes;
+
+        /**
+         * The number of levels below the root of the tree.
+         */
+        size_t treeDepth;
+
+        /**
+         * The lower and upper corners of the bounding box of each node, D values per node.
+         */
+        std::vector<T> nodeLowerCorners;
+        std::vector<T> nodeUpperCorners;
+
+        /**
+         * The sum of the points in each node, D values per node.
+         */
+        std::vector<double> nodeSums;
+
+        /**
+         * The roots of the subtrees which are filtered independently. They only depend on the
+         * tree, so reducing their sums in order gives the same result for any number of threads.
+         */
+        std::vector<size_t> subtreeRoots;
+        std::vector<SubtreeState> subtreeStates;
+
+        blaze::DynamicMatrix<double> centroidSums;
+        blaze::DynamicVector<size_t> centroidCounts;
+
+        /**
+         * The centers used in the last call to `assign`.
+         */
+        blaze::DynamicMatrix<T> lastCenters;
+
+        void
+        buildTree(const blaze::DynamicMatrix<T> &data);
+
+        size_t
+        buildNode(const blaze::DynamicMatrix<T> &data, size_t beginPoint, size_t endPoint, size_t depth);
+
+        /**
+         * Whether `candidate` is farther than `closest` from every point in the bounding box of the node.
+         */
+        bool
+        isFarther(const blaze::DynamicMatrix<T> &centers, size_t candidate, size_t closest, size_t node) const;
+
+        void
+        filter(const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<T> &centers, ClusterAssignmentList &assignments,
+               size_t node, size_t depth, SubtreeState &state) const;
+    };
+}
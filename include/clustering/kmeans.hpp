@@ -1,22 +1,100 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
 #include <memory>
 #include <iostream>
 #include <random>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 #include <blaze/Math.h>
 #include <boost/array.hpp>
 #include <boost/range/algorithm_ext/erase.hpp>
 
+#include <clustering/afkmc2.hpp>
+#include <clustering/assignment_engine.hpp>
+#include <clustering/blocked_assignment.hpp>
 #include <clustering/cluster_assignment_list.hpp>
 #include <clustering/clustering_result.hpp>
+#include <clustering/fixed_dimension_assignment.hpp>
+#include <clustering/kmeans_parallel.hpp>
+#include <clustering/kmeans_plus_plus.hpp>
+#include <clustering/simd_assignment.hpp>
+#include <clustering/sparse_assignment.hpp>
+#include <utils/checkpoint.hpp>
+#include <utils/logging.hpp>
+#include <utils/parallel.hpp>
 #include <utils/random.hpp>
 
 namespace clustering
 {
+    /**
+     * The maximum number of row partitions whose centroid sums are accumulated separately in Lloyd's algorithm.
+     */
+    const size_t MaxAccumulatorPartitions = 64;
+
+    /**
+     * The minimum number of points in a row partition of Lloyd's algorithm.
+     */
+    const size_t MinPointsPerAccumulatorPartition = 4096;
+
+    /**
+     * The maximum number of bytes taken by the centroid sums of all row partitions of Lloyd's algorithm.
+     */
+    const size_t MaxAccumulatorBytes = size_t(32) << 20;
+
+    /**
+     * @brief Returns the number of row partitions whose centroid sums are accumulated separately.
+     *
+     * The partitions only depend on the number of points and the size of the sums, never on the number
+     * of threads, so the reduced sums are identical for any number of threads.
+     *
+     * @param numOfPoints The number of points which are summed up.
+     * @param accumulatorBytes The number of bytes taken by the sums of one partition.
+     */
+    inline size_t
+    getNumberOfAccumulatorPartitions(size_t numOfPoints, size_t accumulatorBytes)
+    {
+        const size_t maxPartitionsInMemory = MaxAccumulatorBytes / std::max<size_t>(1, accumulatorBytes);
+        return std::max<size_t>(1, std::min({MaxAccumulatorPartitions, numOfPoints / MinPointsPerAccumulatorPartition, maxPartitionsInMemory}));
+    }
+
+    /**
+     * @brief Methods to pick the initial centers of k-Means.
+     */
+    enum class InitialisationMethod
+    {
+        /**
+         * Pick the initial centers uniformly at random.
+         */
+        Random,
+
+        /**
+         * Pick the initial centers with k-Means++, which needs one pass over the data per center.
+         */
+        KMeansPlusPlus,
+
+        /**
+         * Pick the initial centers with k-Means|| which oversamples candidates in a few parallel passes.
+         */
+        KMeansParallel,
+
+        /**
+         * Pick the initial centers with AFK-MC² which approximates k-Means++ with Markov chains after a single pass.
+         */
+        AFKMC2
+    };
+
     /**
      * @brief Implementation of the k-Means clustering algorithm.
+     *
+     * The data may be stored in single (float) or double precision. Distances are computed in the
+     * precision of the data while centroid sums are accumulated in `AccumulatorT`, so running on
+     * float data with a double accumulator halves the memory traffic of the assignment step
+     * without losing precision in the centroids: `kMeans.run<float, double>(data)`.
      */
     class KMeans
     {
@@ -25,44 +103,329 @@ namespace clustering
          * @brief Creates a new instance of KMeans.
          * @param numOfClusters The number of clusters to generate.
          * @param initKMeansPlusPlus Initialise centroids using k-Means++.
-         * @param precomputeDistances Precompute pairwise distances to speed up computation.
+         * @param precomputeDistances Cache pairwise distances within a bounded memory budget to speed up seeding.
          * @param maxIterations Maximum number of iterations.
          * @param convergenceDiff The difference in the norms of the centroids when to stop k-Means iteration.
+         * @param assignmentMode The strategy used to assign points to centroids in each iteration.
+         * @param numThreads The number of threads used by Lloyd's algorithm. Zero means one per hardware core.
+         * @param numRestarts The number of independent seed-and-Lloyd trials. The trial with the lowest cost is returned.
          */
-        KMeans(uint numOfClusters, bool initKMeansPlusPlus = true, bool precomputeDistances = false, uint maxIterations = 100, double convergenceDiff = 0.0001);
+        KMeans(uint numOfClusters, bool initKMeansPlusPlus = true, bool precomputeDistances = false, uint maxIterations = 100, double convergenceDiff = 0.0001, AssignmentMode assignmentMode = AssignmentMode::Standard, uint numThreads = 1, uint numRestarts = 1);
+
+        /**
+         * @brief Creates a new instance of KMeans.
+         * @param numOfClusters The number of clusters to generate.
+         * @param initMethod The method used to pick the initial centroids.
+         * @param precomputeDistances Cache pairwise distances within a bounded memory budget to speed up k-Means++ seeding.
+         * @param maxIterations Maximum number of iterations.
+         * @param convergenceDiff The difference in the norms of the centroids when to stop k-Means iteration.
+         * @param assignmentMode The strategy used to assign points to centroids in each iteration.
+         * @param numThreads The number of threads used by Lloyd's algorithm. Zero means one per hardware core.
+         * @param numRestarts The number of independent seed-and-Lloyd trials. The trial with the lowest cost is returned.
+         */
+        KMeans(uint numOfClusters, InitialisationMethod initMethod, bool precomputeDistances = false, uint maxIterations = 100, double convergenceDiff = 0.0001, AssignmentMode assignmentMode = AssignmentMode::Standard, uint numThreads = 1, uint numRestarts = 1);
 
         /**
          * @brief Runs the algorithm.
+         *
+         * With several restarts the trials run concurrently over the same data, each one seeded from
+         * its own random stream, and data derived from the points such as their norms is computed
+         * once and shared. The threads are divided between the trials.
+         *
          * @param data A NxD data matrix containing N data points where each point has D dimensions.
+         * @tparam T The scalar type of the data, float or double.
+         * @tparam AccumulatorT The scalar type used to accumulate centroid sums.
+         */
+        template <typename T, typename AccumulatorT = T>
+        std::shared_ptr<ClusteringResult>
+        run(const blaze::DynamicMatrix<T> &data);
+
+        /**
+         * @brief Runs the algorithm on weighted points, e.g., the points of a coreset.
+         *
+         * The result minimises the weighted cost sum_p w(p) * D^2(p), so clustering a coreset gives
+         * centers for the full dataset from far fewer points. The seeding picks points with
+         * probability proportional to w(p) * D^2(p) and the centroids are weighted means. Only random
+         * and k-Means++ initialisation are supported, random initialisation picks distinct points
+         * with probability proportional to their weights.
+         *
+         * @param data A NxD data matrix containing N data points where each point has D dimensions.
+         * @param weights The non-negative weight of each point. At least K points must have a positive weight.
+         * @tparam T The scalar type of the data, float or double.
+         * @tparam AccumulatorT The scalar type used to accumulate centroid sums.
+         */
+        template <typename T, typename AccumulatorT = T>
+        std::shared_ptr<ClusteringResult>
+        run(const blaze::DynamicMatrix<T> &data, const blaze::DynamicVector<double> &weights);
+
+        /**
+         * @brief Runs the algorithm on sparse data, e.g., bag-of-words documents.
+         *
+         * The points stay in compressed row (CSR) format and only the K centroids are dense, so the
+         * memory is O(nnz + K*D) instead of O(N*D). Points are assigned with sparse dot products and
+         * cached centroid norms regardless of the assignment mode. Only random and k-Means++
+         * initialisation are supported.
+         *
+         * @param data A NxD sparse data matrix containing N data points where each point has D dimensions.
+         * @tparam T The scalar type of the data, float or double.
+         * @tparam AccumulatorT The scalar type used to accumulate centroid sums.
+         */
+        template <typename T, typename AccumulatorT = T>
+        std::shared_ptr<ClusteringResult>
+        run(const blaze::CompressedMatrix<T> &data);
+
+        /**
+         * @brief Runs Lloyd's algorithm from the given centroids instead of seeding, e.g., to re-cluster data after rows were appended.
+         *
+         * Restarts are not used since the run does not depend on a random stream.
+         *
+         * @param data A NxD data matrix containing N data points where each point has D dimensions.
+         * @param initialCentroids A KxD matrix with the centroids to start from, e.g., the centroids of a previous result.
+         * @tparam T The scalar type of the data, float or double.
+         * @tparam AccumulatorT The scalar type used to accumulate centroid sums.
+         */
+        template <typename T, typename AccumulatorT = T>
+        std::shared_ptr<ClusteringResult>
+        run(const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<double> &initialCentroids);
+
+        /**
+         * @brief Runs Lloyd's algorithm from the centroids and the assignments of a previous run on the first M rows of the data.
+         *
+         * The first iteration keeps the previous assignments of the first M points and only computes
+         * the distances of the N - M new points to the centroids. The following iterations assign all
+         * points, so the previous assignments of rows which were updated in place are corrected from
+         * the second iteration on.
+         *
+         * @param data A NxD data matrix whose first M rows are the points of the previous run.
+         * @param initialCentroids The KxD centroids of the previous run.
+         * @param previousAssignments The assignments of the M points of the previous run to `initialCentroids`.
+         * @tparam T The scalar type of the data, float or double.
+         * @tparam AccumulatorT The scalar type used to accumulate centroid sums.
          */
+        template <typename T, typename AccumulatorT = T>
         std::shared_ptr<ClusteringResult>
-        run(const blaze::DynamicMatrix<double> &data);
+        run(const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<double> &initialCentroids, const ClusterAssignmentList &previousAssignments);
+
+        /**
+         * @brief Runs Lloyd's algorithm on sparse data from the given centroids instead of seeding.
+         * @param data A NxD sparse data matrix containing N data points where each point has D dimensions.
+         * @param initialCentroids A KxD matrix with the centroids to start from.
+         */
+        template <typename T, typename AccumulatorT = T>
+        std::shared_ptr<ClusteringResult>
+        run(const blaze::CompressedMatrix<T> &data, const blaze::DynamicMatrix<double> &initialCentroids);
+
+        /**
+         * @brief Runs Lloyd's algorithm on sparse data from the centroids and the assignments of a previous run on the first M rows.
+         * @param data A NxD sparse data matrix whose first M rows are the points of the previous run.
+         * @param initialCentroids The KxD centroids of the previous run.
+         * @param previousAssignments The assignments of the M points of the previous run to `initialCentroids`.
+         */
+        template <typename T, typename AccumulatorT = T>
+        std::shared_ptr<ClusteringResult>
+        run(const blaze::CompressedMatrix<T> &data, const blaze::DynamicMatrix<double> &initialCentroids, const ClusterAssignmentList &previousAssignments);
 
         /**
          * @brief Picks `k` points as the initial centers using the k-Means++ initialisation procedure.
          * @param dataMatrix A NxD data matrix containing N data points where each point has D dimensions.
-         * @param precomputeDistances Whether to precompute pairwise distances.
+         * @param precomputeDistances Whether to cache pairwise distances, see `PairwiseDistanceCache`.
          */
+        template <typename T>
         std::vector<size_t>
-        pickInitialCentersViaKMeansPlusPlus(const blaze::DynamicMatrix<double> &dataMatrix, const bool precomputeDistances);
+        pickInitialCentersViaKMeansPlusPlus(const blaze::DynamicMatrix<T> &dataMatrix, const bool precomputeDistances);
 
-        blaze::DynamicMatrix<double>
-        copyRows(const blaze::DynamicMatrix<double> &data, const std::vector<size_t> &indicesToCopy);
+        /**
+         * @brief Picks `k` points as the initial centers using the k-Means++ initialisation procedure.
+         * @param dataMatrix A NxD data matrix containing N data points where each point has D dimensions.
+         * @param distanceCache Cache of pairwise distances between the points, which may be shared with other algorithms. Can be null.
+         */
+        template <typename T>
+        std::vector<size_t>
+        pickInitialCentersViaKMeansPlusPlus(const blaze::DynamicMatrix<T> &dataMatrix, std::shared_ptr<PairwiseDistanceCache<T>> distanceCache);
+
+        /**
+         * @brief Picks `k` weighted points as the initial centers with probability proportional to w(p) * D^2(p).
+         * @param dataMatrix A NxD data matrix containing N data points where each point has D dimensions.
+         * @param weights The non-negative weight of each point.
+         */
+        template <typename T>
+        std::vector<size_t>
+        pickInitialCentersViaKMeansPlusPlus(const blaze::DynamicMatrix<T> &dataMatrix, const blaze::DynamicVector<double> &weights);
+
+        /**
+         * @brief Picks `k` points as the initial centers using the k-Means++ initialisation procedure.
+         * @param dataMatrix A NxD sparse data matrix containing N data points where each point has D dimensions.
+         */
+        template <typename T>
+        std::vector<size_t>
+        pickInitialCentersViaKMeansPlusPlus(const blaze::CompressedMatrix<T> &dataMatrix);
+
+        /**
+         * @brief Picks `k` points as the initial centers using the k-Means|| initialisation procedure.
+         * @param dataMatrix A NxD data matrix containing N data points where each point has D dimensions.
+         */
+        template <typename T>
+        std::vector<size_t>
+        pickInitialCentersViaKMeansParallel(const blaze::DynamicMatrix<T> &dataMatrix);
+
+        /**
+         * @brief Picks `k` points as the initial centers using the AFK-MC² initialisation procedure.
+         * @param dataMatrix A NxD data matrix containing N data points where each point has D dimensions.
+         */
+        template <typename T>
+        std::vector<size_t>
+        pickInitialCentersViaAFKMC2(const blaze::DynamicMatrix<T> &dataMatrix);
+
+        /**
+         * @brief Periodically saves the state of Lloyd's algorithm to a file, and resumes from it if the file exists when a run starts.
+         *
+         * A checkpoint holds the centroids, the assignments and the iteration counter and is written
+         * on a background thread. A resumed run skips the seeding and continues with the next
+         * iteration. With several restarts each trial has its own file, named after the trial index.
+         * The files are deleted once the run has completed. A checkpoint also records the shape and a
+         * fingerprint of the data, the number of clusters, the initialisation method, the maximum
+         * number of iterations and the weights, and resuming it with a run that differs in any of
+         * them throws std::invalid_argument.
+         *
+         * @param filePath The path of the checkpoint file. An empty path disables checkpoints.
+         * @param interval The number of iterations between two checkpoints.
+         */
+        void
+        enableCheckpoints(const std::string &filePath, size_t interval = 1);
+
+        template <typename T>
+        blaze::DynamicMatrix<T>
+        copyRows(const blaze::DynamicMatrix<T> &data, const std::vector<size_t> &indicesToCopy);
+
+        template <typename T>
+        blaze::DynamicMatrix<T>
+        copyRows(const blaze::CompressedMatrix<T> &data, const std::vector<size_t> &indicesToCopy);
 
     private:
         const size_t NumOfClusters;
-        const bool InitKMeansPlusPlus;
+        const InitialisationMethod InitMethod;
         const size_t MaxIterations;
         const double ConvergenceDiff;
         const bool PrecomputeDistances;
+        const AssignmentMode Mode;
+        const size_t NumThreads;
+        const size_t NumRestarts;
+
+        std::string checkpointPath;
+
+        size_t checkpointInterval = 1;
+
+        /**
+         * @brief Returns the path of the checkpoint file of a trial, or an empty path if checkpoints are disabled.
+         */
+        std::string
+        getCheckpointPath(size_t trial) const;
+
+        /**
+         * @brief Reads the checkpoint of each trial and checks that it can be resumed by a run on the given data.
+         * @return The checkpoint of each trial, null for trials without a checkpoint.
+         * @throws std::invalid_argument if a checkpoint was written by a run on other data or with another configuration.
+         * @throws std::runtime_error if a checkpoint file is not a valid checkpoint.
+         */
+        template <typename MatrixT>
+        std::vector<std::shared_ptr<const utils::Checkpoint>>
+        readTrialCheckpoints(const MatrixT &data, const blaze::DynamicVector<double> *pointWeights) const;
+
+        /**
+         * @brief Deletes the checkpoint files of all trials once a run has completed, so the next run starts from scratch.
+         */
+        void
+        removeCheckpoints() const;
+
+        /**
+         * @brief Runs `NumRestarts` trials on a pool of threads and returns the result with the lowest cost.
+         * @param runTrial Called as runTrial(random, numThreads, trial) for each trial with the random stream of the trial.
+         */
+        std::shared_ptr<ClusteringResult>
+        runTrials(const std::function<std::shared_ptr<ClusteringResult>(utils::Random &, size_t, size_t)> &runTrial);
+
+        /**
+         * @brief Seeds and runs `NumRestarts` trials of Lloyd's algorithm on dense data.
+         * @param pointWeights The weight of each point. Can be null.
+         */
+        template <typename T, typename AccumulatorT>
+        std::shared_ptr<ClusteringResult>
+        runWithSeeding(const blaze::DynamicMatrix<T> &data, const blaze::DynamicVector<double> *pointWeights);
+
+        /**
+         * @brief Picks `k` points as the initial centers using the given initialisation method.
+         * @param distanceCache Cache of pairwise distances used by k-Means++. Can be null.
+         * @param pointWeights The weight of each point, only for random and k-Means++ initialisation. Can be null.
+         */
+        template <typename T>
+        std::vector<size_t>
+        pickInitialCenters(const blaze::DynamicMatrix<T> &dataMatrix, InitialisationMethod initMethod, std::shared_ptr<PairwiseDistanceCache<T>> distanceCache, utils::Random &random, size_t numThreads,
+                           const blaze::DynamicVector<double> *pointWeights = nullptr);
+
+        /**
+         * @brief Picks `k` sparse points as the initial centers using the given initialisation method.
+         */
+        template <typename T>
+        std::vector<size_t>
+        pickInitialCenters(const blaze::CompressedMatrix<T> &dataMatrix, InitialisationMethod initMethod, utils::Random &random, size_t numThreads);
+
+        /**
+         * @brief Picks `k` points uniformly at random as the initial centers.
+         * @param numOfPoints The number of points to pick from.
+         */
+        std::vector<size_t>
+        pickInitialCentersRandomly(size_t numOfPoints, utils::Random &random);
+
+        /**
+         * @brief Picks `k` distinct points at random with probability proportional to their weights.
+         */
+        std::vector<size_t>
+        pickInitialCentersRandomly(const blaze::DynamicVector<double> &pointWeights, utils::Random &random);
+
+        /**
+         * @brief Checks that there is a finite, non-negative weight for each point and that at least K weights are positive.
+         * @throws std::invalid_argument if the weights are not valid.
+         */
+        void
+        validatePointWeights(size_t numOfPoints, const blaze::DynamicVector<double> &pointWeights) const;
+
+        /**
+         * @brief Checks that warm start centroids and assignments match the data and the number of clusters.
+         * @throws std::invalid_argument if they do not match.
+         */
+        void
+        validateWarmStart(size_t numOfPoints, size_t numOfDimensions, const blaze::DynamicMatrix<double> &initialCentroids, const ClusterAssignmentList *previousAssignments) const;
 
         /**
          * @brief Run Lloyd's algorithm to perform the clustering of data points.
          * @param dataMatrix A NxD data matrix containing N data points where each point has D dimensions.
-         * @param dataMatrix Initial k centroids where k is the number of required clusters.
+         * @param initialCentroids Initial k centroids where k is the number of required clusters.
+         * @param dataSquaredNorms Squared norms of the data points shared between trials. Can be null.
+         * @param numThreads The number of threads used by this run.
+         * @param previousAssignments Assignments of the first M points to `initialCentroids` which are kept in the first iteration. Can be null.
+         * @param checkpointFilePath The path of the checkpoint file of this run. Empty if checkpoints are disabled.
+         * @param resumeFrom The checkpoint to resume from instead of `initialCentroids`. Can be null.
+         * @param pointWeights The weight of each point, which makes the centroids weighted means. Can be null.
+         */
+        template <typename T, typename AccumulatorT>
+        std::shared_ptr<ClusteringResult>
+        runLloydsAlgorithm(const blaze::DynamicMatrix<T> &dataMatrix, blaze::DynamicMatrix<T> initialCentroids, std::shared_ptr<const blaze::DynamicVector<T>> dataSquaredNorms, size_t numThreads, const ClusterAssignmentList *previousAssignments = nullptr,
+                           const std::string &checkpointFilePath = std::string(), std::shared_ptr<const utils::Checkpoint> resumeFrom = nullptr, const blaze::DynamicVector<double> *pointWeights = nullptr);
+
+        /**
+         * @brief Run Lloyd's algorithm on sparse data points with dense centroids.
+         * @param dataMatrix A NxD sparse data matrix containing N data points where each point has D dimensions.
+         * @param initialCentroids Initial k centroids where k is the number of required clusters.
+         * @param dataSquaredNorms Squared norms of the data points.
+         * @param numThreads The number of threads used by this run.
+         * @param previousAssignments Assignments of the first M points to `initialCentroids` which are kept in the first iteration. Can be null.
+         * @param checkpointFilePath The path of the checkpoint file of this run. Empty if checkpoints are disabled.
+         * @param resumeFrom The checkpoint to resume from instead of `initialCentroids`. Can be null.
          */
+        template <typename T, typename AccumulatorT>
         std::shared_ptr<ClusteringResult>
-        runLloydsAlgorithm(const blaze::DynamicMatrix<double> &dataMatrix, blaze::DynamicMatrix<double> initialCentroids);
+        runLloydsAlgorithm(const blaze::CompressedMatrix<T> &dataMatrix, blaze::DynamicMatrix<T> initialCentroids, const blaze::DynamicVector<T> &dataSquaredNorms, size_t numThreads, const ClusterAssignmentList *previousAssignments = nullptr,
+                           const std::string &checkpointFilePath = std::string(), std::shared_ptr<const utils::Checkpoint> resumeFrom = nullptr);
     };
 
 }
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include <blaze/Math.h>
+
+#include <clustering/blocked_assignment.hpp>
+#include <clustering/cluster_assignment_list.hpp>
+#include <clustering/kmeans_plus_plus.hpp>
+#include <utils/logging.hpp>
+#include <utils/parallel.hpp>
+#include <utils/random.hpp>
+
+namespace clustering
+{
+    /**
+     * The number of oversampling rounds of k-Means||.
+     */
+    const size_t KMeansParallelRounds = 5;
+
+    /**
+     * The expected number of candidates sampled in each round of k-Means|| relative to k.
+     */
+    const double KMeansParallelOversampling = 2.0;
+
+    /**
+     * @brief k-Means|| initialisation (Bahmani et al., 2012).
+     *
+     * Instead of one pass over the data per center, each round samples every point independently
+     * with probability l*D^2(p)/cost where l = 2k. After a few rounds, the candidates are weighted
+     * by the number of points closest to them and reduced to k centers with weighted k-Means++.
+     * Only the passes that update the distances touch the whole dataset and they run in parallel.
+     */
+    template <typename T>
+    class KMeansParallelInitialiser
+    {
+    public:
+        /**
+         * @brief Creates a new instance of KMeansParallelInitialiser.
+         * @param data A NxD data matrix containing N data points where each point has D dimensions. The matrix is not copied and must outlive the initialiser.
+         * @param numThreads The number of threads used to update the distances.
+         * @param numRounds The number of oversampling rounds.
+         * @param oversamplingFactor The expected number of candidates sampled in each round relative to k.
+         */
+        KMeansParallelInitialiser(const blaze::DynamicMatrix<T> &data, size_t numThreads = 1, size_t numRounds = KMeansParallelRounds, double oversamplingFactor = KMeansParallelOversampling);
+
+        /**
+         * @brief Picks `k` points as centers.
+         * @param k The number of centers to pick.
+         * @param random The random number generator used to pick the centers.
+         */
+        std::vector<size_t>
+        pickCenters(size_t k, utils::Random &random);
+
+    private:
+        const blaze::DynamicMatrix<T> &data;
+        const size_t NumThreads;
+        const size_t NumRounds;
+        const double OversamplingFactor;
+
+        blaze::DynamicVector<T> dataSquaredNorms;
+        blaze::DynamicVector<double> minSquaredDistances;
+
+        /**
+         * @brief Copies the candidate points into a matrix.
+         */
+        blaze::DynamicMatrix<T>
+        copyCandidates(const std::vector<size_t> &candidates) const;
+
+        /**
+         * @brief Assigns every point to its closest candidate in parallel.
+         */
+        void
+        assignToCandidates(const std::vector<size_t> &candidates, ClusterAssignmentList &assignments);
+
+        /**
+         * @brief Lowers the distance of each point to its closest candidate given a batch of new candidates.
+         */
+        void
+        updateDistances(const std::vector<size_t> &newCandidates);
+    };
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <iostream>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <blaze/Math.h>
+
+#include <clustering/distance_cache.hpp>
+#include <clustering/simd_assignment.hpp>
+#include <clustering/sparse_assignment.hpp>
+#include <utils/logging.hpp>
+#include <utils/parallel.hpp>
+#include <utils/random.hpp>
+
+namespace clustering
+{
+    /**
+     * @brief Incremental k-Means++ seeding.
+     *
+     * Keeps the squared distance between each point and its closest center picked so far. When a
+     * new center is added only the distances to that center are computed, so picking k centers
+     * costs O(N*K*D) instead of O(N*K^2*D). The distances are kept in a sum-tree so only points
+     * whose distance changed are updated before the next center is drawn.
+     *
+     * @tparam T The scalar type of the data.
+     * @tparam MatrixT The type of the data matrix, either `blaze::DynamicMatrix<T>` or a sparse
+     *                 `blaze::CompressedMatrix<T>` whose distances only visit the nonzero entries.
+     */
+    template <typename T, typename MatrixT = blaze::DynamicMatrix<T>>
+    class KMeansPlusPlusSeeder
+    {
+    public:
+        /**
+         * @brief Creates a new instance of KMeansPlusPlusSeeder.
+         * @param data A NxD data matrix containing N data points where each point has D dimensions. The matrix is not copied and must outlive the seeder.
+         * @param numThreads The number of threads used to update the distances.
+         * @param distanceCache Optional cache of squared pairwise distances between the points, only for dense data.
+         */
+        KMeansPlusPlusSeeder(const MatrixT &data, size_t numThreads = 1, std::shared_ptr<PairwiseDistanceCache<T>> distanceCache = nullptr);
+
+        /**
+         * @brief Picks `k` points as centers using the k-Means++ initialisation procedure.
+         * @param k The number of centers to pick.
+         * @param random The random number generator used to pick the centers.
+         */
+        std::vector<size_t>
+        pickCenters(size_t k, utils::Random &random);
+
+        /**
+         * @brief Sets the weight of each point so points are picked with probability proportional to w(p)*D^2(p).
+         *
+         * Must be called before any center is picked.
+         */
+        void
+        setPointWeights(const blaze::DynamicVector<double> &weights);
+
+        /**
+         * @brief Adds a point as a center and updates the distances of all points to their closest center.
+         * @param pointIndex The index of the point to use as a center.
+         */
+        void
+        addCenter(size_t pointIndex);
+
+        /**
+         * @brief Returns the squared distance between each point and its closest center: D^2(p)
+         */
+        const blaze::DynamicVector<double> &
+        getMinSquaredDistances() const;
+
+        /**
+         * @brief Returns the indices of the points picked as centers so far.
+         */
+        const std::vector<size_t> &
+        getCenters() const;
+
+    private:
+        const MatrixT &data;
+        const size_t NumThreads;
+        std::shared_ptr<PairwiseDistanceCache<T>> distanceCache;
+
+        blaze::DynamicVector<double> minSquaredDistances;
+        utils::WeightedSampler minSquaredDistanceSampler;
+        std::vector<char> distanceChanged;
+
+        /**
+         * The weight of each point, empty when all points have unit weight.
+         */
+        blaze::DynamicVector<double> pointWeights;
+        std::vector<size_t> centers;
+    };
+}
@@ -11,7 +11,10 @@
 
 #include <clustering/cluster_assignment_list.hpp>
 #include <clustering/clustering_result.hpp>
+#include <clustering/distance_cache.hpp>
 #include <clustering/kmeans.hpp>
+#include <utils/checkpoint.hpp>
+#include <utils/logging.hpp>
 #include <utils/random.hpp>
 
 namespace clustering
@@ -21,26 +24,65 @@ namespace clustering
     public:
         /**
          * @brief Creates a new instance of LocalSearch. 
+         * @param numOfClusters The number of clusters to generate.
+         * @param swapSize The number of centers to swap at a time.
+         * @param useDistanceCache Cache pairwise distances so swaps look up distances instead of computing them.
+         * @param distanceCacheBudget The memory budget of the distance cache in bytes.
          */
-        LocalSearch(uint numOfClusters, uint swapSize);
+        LocalSearch(uint numOfClusters, uint swapSize, bool useDistanceCache = false, size_t distanceCacheBudget = DefaultDistanceCacheBudget);
 
         /**
          * @brief Runs the algorithm.
          * @param data A NxD data matrix containing N data points where each point has D dimensions.
          */
+        template <typename T>
         std::shared_ptr<ClusteringResult>
-        run(const blaze::DynamicMatrix<double> &data);
+        run(const blaze::DynamicMatrix<T> &data);
 
         /**
          * @brief Runs the faster version of the algorithm.
          * @param data A NxD data matrix containing N data points where each point has D dimensions.
          */
+        template <typename T>
         std::shared_ptr<ClusteringResult>
-        runPlusPlus(const blaze::DynamicMatrix<double> &data, size_t nSamples, size_t nIterations);
+        runPlusPlus(const blaze::DynamicMatrix<T> &data, size_t nSamples, size_t nIterations);
+
+        /**
+         * @brief Periodically saves the state of the search to a file, and resumes from it if the file exists when a run starts.
+         *
+         * A checkpoint holds the current and the best centers, their assignments, the iteration
+         * counter and the state of the random engine, and is written on a background thread. `run`
+         * takes a checkpoint after every `interval` swapped clusters and `runPlusPlus` before every
+         * `interval` iterations. The file is deleted once the search has completed. A checkpoint also
+         * records the shape and a fingerprint of the data, the number of clusters and, for `runPlusPlus`,
+         * the number of samples and iterations, and resuming it with a search that differs in any of
+         * them throws std::invalid_argument.
+         *
+         * @param filePath The path of the checkpoint file. An empty path disables checkpoints.
+         * @param interval The number of iterations between two checkpoints.
+         */
+        void
+        enableCheckpoints(const std::string &filePath, size_t interval = 1);
     
     private:
         uint numOfClusters;
 
         uint swapSize;
+
+        bool useDistanceCache;
+
+        size_t distanceCacheBudget;
+
+        std::string checkpointPath;
+
+        size_t checkpointInterval = 1;
+
+        /**
+         * @brief Assigns points to the centers, using the distance cache if there is one.
+         */
+        template <typename T>
+        void
+        assignPoints(ClusterAssignmentList &clusterAssignments, const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<T> &centers,
+                     const std::vector<size_t> &centerPoints, std::shared_ptr<PairwiseDistanceCache<T>> distanceCache);
     };
 }
\ No newline at end of file
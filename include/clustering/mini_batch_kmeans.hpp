@@ -0,0 +1,68 @@
+#pragma once
+
+#include <memory>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include <blaze/Math.h>
+
+#include <clustering/cluster_assignment_list.hpp>
+#include <clustering/clustering_result.hpp>
+#include <clustering/kmeans.hpp>
+#include <utils/logging.hpp>
+#include <utils/random.hpp>
+
+namespace clustering
+{
+    /**
+     * @brief Implementation of mini-batch k-Means (Sculley, 2010).
+     *
+     * Each iteration samples a batch of points and moves their closest centers towards them using
+     * a per-center learning rate of 1/v(c) where v(c) is the number of points assigned to center c
+     * so far. The cost of an iteration depends on the batch size and not on the size of the dataset.
+     */
+    class MiniBatchKMeans
+    {
+    public:
+        /**
+         * @brief Creates a new instance of MiniBatchKMeans.
+         * @param numOfClusters The number of clusters to generate.
+         * @param batchSize The number of points sampled in each iteration.
+         * @param maxIterations Maximum number of iterations.
+         * @param convergenceDiff The difference in the norms of the centroids when to stop iterating.
+         */
+        MiniBatchKMeans(uint numOfClusters, size_t batchSize = 1024, uint maxIterations = 100, double convergenceDiff = 0.0001);
+
+        /**
+         * @brief Runs the algorithm.
+         * @param data A NxD data matrix containing N data points where each point has D dimensions.
+         * @throws std::invalid_argument if the data has fewer rows than the number of clusters.
+         */
+        template <typename T>
+        std::shared_ptr<ClusteringResult>
+        run(const blaze::DynamicMatrix<T> &data);
+
+    private:
+        const size_t NumOfClusters;
+        const size_t BatchSize;
+        const size_t MaxIterations;
+        const double ConvergenceDiff;
+
+        utils::Random random;
+
+        /**
+         * @brief Picks initial centers by running k-Means++ on a uniform sample of the data.
+         */
+        template <typename T>
+        blaze::DynamicMatrix<T>
+        pickInitialCenters(const blaze::DynamicMatrix<T> &data, utils::RandomIndexer &pointSampler);
+
+        /**
+         * @brief Copies `numOfSamples` rows picked uniformly at random with replacement.
+         */
+        template <typename T>
+        blaze::DynamicMatrix<T>
+        sampleRows(const blaze::DynamicMatrix<T> &data, size_t numOfSamples, utils::RandomIndexer &pointSampler);
+    };
+}
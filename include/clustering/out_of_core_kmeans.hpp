@@ -0,0 +1,95 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include <blaze/Math.h>
+
+#include <clustering/blocked_assignment.hpp>
+#include <clustering/cluster_assignment_list.hpp>
+#include <clustering/clustering_result.hpp>
+#include <clustering/fixed_dimension_assignment.hpp>
+#include <clustering/kmeans.hpp>
+#include <clustering/simd_assignment.hpp>
+#include <data/block_file.hpp>
+#include <utils/logging.hpp>
+#include <utils/parallel.hpp>
+#include <utils/random.hpp>
+
+namespace clustering
+{
+    /**
+     * The default number of rows which `OutOfCoreKMeans` reads from disk at a time.
+     */
+    const size_t DefaultBlockRows = 65536;
+
+    /**
+     * @brief Implementation of Lloyd's algorithm over a dataset in a block file which does not have to fit in memory.
+     *
+     * Each iteration streams the rows from disk in blocks with a fixed number of rows. Only the centroids,
+     * the centroid sums, a 32-bit label per point and two blocks are kept in memory: while one block is
+     * assigned, the next block is read on a background thread. Centroid sums are accumulated per block in
+     * fixed partitions and reduced in block order, so the result does not depend on the number of threads.
+     */
+    class OutOfCoreKMeans
+    {
+    public:
+        /**
+         * @brief Creates a new instance of OutOfCoreKMeans.
+         * @param numOfClusters The number of clusters to generate.
+         * @param blockRows The number of rows read from disk at a time.
+         * @param maxIterations Maximum number of iterations.
+         * @param convergenceDiff The difference in the norms of the centroids when to stop iterating.
+         * @param numThreads The number of threads used to process a block. Zero means one thread per hardware core.
+         */
+        OutOfCoreKMeans(uint numOfClusters, size_t blockRows = DefaultBlockRows, uint maxIterations = 100, double convergenceDiff = 0.0001, uint numThreads = 1);
+
+        /**
+         * @brief Runs the algorithm.
+         *
+         * The initial centers are picked with k-Means++ on a uniform sample of one block of rows. The
+         * returned assignments are computed in a last pass over the data against the final centroids.
+         *
+         * @param reader The block file containing N data points where each point has D dimensions.
+         * @tparam AccumulatorT The scalar type of the centroid sums, see `KMeans::run`.
+         */
+        template <typename T, typename AccumulatorT = T>
+        std::shared_ptr<ClusteringResult>
+        run(data::BlockFileReader<T> &reader);
+
+    private:
+        const size_t NumOfClusters;
+        const size_t BlockRows;
+        const size_t MaxIterations;
+        const double ConvergenceDiff;
+        const size_t NumThreads;
+
+        utils::Random random;
+
+        /**
+         * @brief Picks initial centers by running k-Means++ on a uniform sample of the rows in the block file.
+         */
+        template <typename T>
+        blaze::DynamicMatrix<T>
+        pickInitialCenters(data::BlockFileReader<T> &reader);
+
+        /**
+         * @brief Reads all blocks once, prefetching the next block while `processBlock` is called on the current one.
+         * @param processBlock Called as processBlock(firstRow, block) for the blocks in order.
+         */
+        template <typename T>
+        void
+        forEachBlock(data::BlockFileReader<T> &reader, const std::function<void(size_t, const blaze::DynamicMatrix<T> &)> &processBlock);
+
+        /**
+         * @brief Assigns all points of a block to their closest centers.
+         */
+        template <typename T>
+        void
+        assignBlock(const blaze::DynamicMatrix<T> &block, const blaze::DynamicMatrix<T> &centroids, ClusterAssignmentList &assignments, size_t numThreads);
+    };
+}
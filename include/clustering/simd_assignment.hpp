@@ -0,0 +1,144 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include <blaze/Math.h>
+
+#include <clustering/cluster_assignment_list.hpp>
+#include <clustering/fixed_dimension_assignment.hpp>
+#include <utils/logging.hpp>
+
+namespace clustering
+{
+    /**
+     * @brief The instruction sets of the vectorised distance kernels, from the narrowest to the widest vectors.
+     */
+    enum class SimdLevel
+    {
+        /**
+         * No vectorised kernel, the callers use their portable kernels.
+         */
+        Scalar = 0,
+
+        /**
+         * 128-bit vectors.
+         */
+        SSE42 = 1,
+
+        /**
+         * 256-bit vectors.
+         */
+        AVX2 = 2,
+
+        /**
+         * 512-bit vectors.
+         */
+        AVX512 = 3
+    };
+
+    /**
+     * The largest size of the centers for which `assignClosestCentersSimd` is used. Each point is compared
+     * with all centers, so larger center matrices are assigned with the cache blocked matrix multiplication.
+     */
+    const size_t MaxSimdCentersBytes = 512 * 1024;
+
+    /**
+     * @brief Returns the widest instruction set which the CPU and the operating system support.
+     *
+     * The instruction set is detected with CPUID once and cached, so a single binary runs the widest
+     * kernels on every machine. Builds for other architectures or compilers always use `SimdLevel::Scalar`.
+     */
+    SimdLevel
+    detectSimdLevel();
+
+    /**
+     * @brief Returns the instruction set used by the vectorised kernels.
+     */
+    SimdLevel
+    getSimdLevel();
+
+    /**
+     * @brief Limits the vectorised kernels to an instruction set, e.g., to compare the kernels with each other.
+     *
+     * Levels which the CPU does not support are lowered to `detectSimdLevel()`.
+     */
+    void
+    setSimdLevel(SimdLevel level);
+
+    const char *
+    getSimdLevelName(SimdLevel level);
+
+    /**
+     * @brief Returns the size of the vectors of an instruction set in bytes.
+     */
+    inline size_t
+    getSimdVectorBytes(SimdLevel level)
+    {
+        return level == SimdLevel::Scalar ? 0 : size_t(8) << static_cast<int>(level);
+    }
+
+    /**
+     * @brief Whether `assignClosestCentersSimd` should be used to assign points with `numOfDimensions`
+     * dimensions to `numOfCenters` centers.
+     *
+     * Low dimensional data with few centers is assigned faster by `assignClosestCentersFixedDimension`,
+     * which does not have to reduce the lanes of the vectors for each point.
+     */
+    template <typename T>
+    inline bool
+    isSimdAssignmentSupported(size_t numOfDimensions, size_t numOfCenters)
+    {
+        const auto level = getSimdLevel();
+        if (level == SimdLevel::Scalar || numOfDimensions * numOfCenters * sizeof(T) > MaxSimdCentersBytes)
+        {
+            return false;
+        }
+
+        const size_t lanes = getSimdVectorBytes(level) / sizeof(T);
+        return !isFixedDimensionSupported(numOfDimensions) || (level >= SimdLevel::AVX2 && numOfCenters >= 2 * lanes);
+    }
+
+    /**
+     * @brief Assigns points to their closest centers with hand-vectorised kernels for the instruction set of `getSimdLevel()`.
+     *
+     * The centers are packed so that each vector holds the same dimension of several centers. Every
+     * coordinate of a point is loaded once and broadcast against up to eight vectors of centers whose
+     * distances are accumulated in registers, and the closest center is tracked per lane. The distances
+     * are summed in the same order as in `assignClosestCentersFixed`, so all instruction sets give
+     * identical assignments and costs.
+     *
+     * @param data A NxD data matrix containing N data points where each point has D dimensions.
+     * @param centers A KxD matrix containing the centers.
+     * @param assignments The cluster assignments to update.
+     * @param beginPoint The first point to assign.
+     * @param endPoint One past the last point to assign.
+     * @return False, without touching `assignments`, if there is no vectorised kernel.
+     */
+    template <typename T>
+    bool
+    assignClosestCentersSimd(const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<T> &centers,
+                             ClusterAssignmentList &assignments, size_t beginPoint, size_t endPoint);
+
+    /**
+     * @brief Computes the squared distances between a range of points and one point of the same matrix
+     * with hand-vectorised kernels for the instruction set of `getSimdLevel()`.
+     *
+     * @param data A NxD data matrix containing N data points where each point has D dimensions.
+     * @param centerIndex The index of the point to compute the distances to.
+     * @param beginPoint The first point.
+     * @param endPoint One past the last point.
+     * @param squaredDistances Receives the squared distance of point `beginPoint + i` at index `i`.
+     * @return False, without touching `squaredDistances`, if there is no vectorised kernel.
+     */
+    template <typename T>
+    bool
+    calcSquaredDistancesSimd(const blaze::DynamicMatrix<T> &data, size_t centerIndex, size_t beginPoint, size_t endPoint,
+                             double *squaredDistances);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <blaze/Math.h>
+
+#include <clustering/cluster_assignment_list.hpp>
+
+namespace clustering
+{
+    /**
+     * @brief Computes the squared L2 norm of each row in the sparse matrix i.e., ||x||^2.
+     */
+    template <typename T>
+    blaze::DynamicVector<T>
+    calcSquaredRowNorms(const blaze::CompressedMatrix<T> &matrix);
+
+    /**
+     * @brief Computes the squared L2 distance between the rows `p` and `q` of the sparse matrix.
+     *
+     * Only the nonzero entries of both rows are visited, so the cost is O(nnz(p) + nnz(q)).
+     */
+    template <typename T>
+    double
+    calcSquaredDistance(const blaze::CompressedMatrix<T> &matrix, size_t p, size_t q);
+
+    /**
+     * @brief Prepares dense centers for `assignClosestCentersSparse`.
+     *
+     * Call it once each time the centers change and share the results between all calls that assign
+     * points to the same centers.
+     *
+     * @param centers A KxD matrix containing the centers.
+     * @param transposedCenters Receives the DxK transpose of `centers`.
+     * @param centerSquaredNorms Receives the squared norms of the K centers.
+     */
+    template <typename T>
+    void
+    prepareSparseAssignmentCenters(const blaze::DynamicMatrix<T> &centers, blaze::DynamicMatrix<T> &transposedCenters,
+                                   blaze::DynamicVector<T> &centerSquaredNorms);
+
+    /**
+     * @brief Assigns sparse points to their closest dense centers using ||x - c||^2 = ||x||^2 - 2x·c + ||c||^2.
+     *
+     * The centers are transposed so the dot products of a point with all centers are accumulated
+     * from contiguous memory, one nonzero entry of the point at a time. Assigning a point costs
+     * O(nnz(x) * K) and the zero entries of the points are never touched.
+     *
+     * @param data A NxD sparse data matrix in compressed row (CSR) format.
+     * @param dataSquaredNorms The squared norms of the rows in `data`, see `calcSquaredRowNorms`.
+     * @param transposedCenters A DxK matrix containing the transposed centers, see `prepareSparseAssignmentCenters`.
+     * @param centerSquaredNorms The squared norms of the centers, see `prepareSparseAssignmentCenters`.
+     * @param assignments The cluster assignments to update.
+     * @param beginPoint The first point to assign.
+     * @param endPoint One past the last point to assign.
+     */
+    template <typename T>
+    void
+    assignClosestCentersSparse(const blaze::CompressedMatrix<T> &data, const blaze::DynamicVector<T> &dataSquaredNorms,
+                               const blaze::DynamicMatrix<T> &transposedCenters, const blaze::DynamicVector<T> &centerSquaredNorms,
+                               ClusterAssignmentList &assignments, size_t beginPoint, size_t endPoint);
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <blaze/Math.h>
+
+#include <clustering/bounded_assignment.hpp>
+#include <clustering/cluster_assignment_list.hpp>
+
+namespace clustering
+{
+    /**
+     * @brief Yinyang k-Means assignment step (Ding et al., 2015).
+     *
+     * The centers are partitioned into t groups and each point keeps one lower bound per group.
+     * A group whose lower bound exceeds the upper bound of a point is skipped entirely, and the
+     * members of the remaining groups are filtered individually before computing any distance.
+     * Memory is O(N*t) where t is roughly K/10 which makes the engine suitable for large K.
+     */
+    template <typename T>
+    class YinyangAssignmentEngine : public BoundedAssignmentEngine<T>
+    {
+    public:
+        /**
+         * @brief Creates a new instance of YinyangAssignmentEngine.
+         * @param numOfPoints The number of points in the dataset.
+         * @param numOfClusters The number of centers.
+         * @param numThreads The number of threads used to assign points.
+         * @param numOfGroups The number of center groups t. Zero means K/10.
+         */
+        YinyangAssignmentEngine(size_t numOfPoints, size_t numOfClusters, size_t numThreads = 1, size_t numOfGroups = 0);
+
+    protected:
+        using BoundedAssignmentEngine<T>::NumOfClusters;
+        using BoundedAssignmentEngine<T>::isInitialised;
+        using BoundedAssignmentEngine<T>::centerShifts;
+        using BoundedAssignmentEngine<T>::upperBounds;
+        using BoundedAssignmentEngine<T>::upperBoundIsTight;
+        using BoundedAssignmentEngine<T>::distance;
+
+        void
+        prepare(const blaze::DynamicMatrix<T> &centers);
+
+        void
+        initialiseBounds(const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<T> &centers, ClusterAssignmentList &assignments, size_t beginPoint, size_t endPoint);
+
+        void
+        updateAssignments(const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<T> &centers, ClusterAssignmentList &assignments, size_t beginPoint, size_t endPoint);
+
+    private:
+        const size_t NumOfGroups;
+
+        /**
+         * The group of each center.
+         */
+        std::vector<size_t> centerGroups;
+
+        /**
+         * The centers belonging to each group.
+         */
+        std::vector<std::vector<size_t>> groupMembers;
+
+        /**
+         * Lower bound on the distance between each point and the centers in each group,
+         * excluding the assigned center of the point: lb(p, g)
+         */
+        blaze::DynamicMatrix<double> lowerBounds;
+
+        /**
+         * The largest shift of any center in each group: Δ(g)
+         */
+        blaze::DynamicVector<double> groupShifts;
+
+        /**
+         * Partitions the initial centers into groups by running a few iterations of k-Means on them.
+         */
+        void
+        groupCenters(const blaze::DynamicMatrix<T> &centers);
+    };
+}
@@ -1,10 +1,15 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <vector>
 #include <iostream>
 
+#include <clustering/clustering_result.hpp>
 #include <clustering/kmeans.hpp>
+#include <coresets/weighted_matrix.hpp>
+#include <utils/logging.hpp>
+#include <utils/parallel.hpp>
 #include <utils/random.hpp>
 
 namespace coresets
@@ -20,9 +25,54 @@ namespace coresets
         }
     };
 
+    /**
+     * @brief A set of weighted data points and centers.
+     *
+     * The entries are stored as flat arrays of indices, weights and center flags in the order they
+     * were added. An open addressing hash index maps (index, isCenter) to the position of an entry, so
+     * adding a point or a center which is already in the coreset only increases its weight in O(1).
+     */
     class Coreset
     {
-        std::vector<std::shared_ptr<WeightedPoint>> points;
+        /**
+         * The data point or cluster index of each entry.
+         */
+        std::vector<size_t> indices;
+
+        /**
+         * The weight of each entry.
+         */
+        std::vector<double> weights;
+
+        /**
+         * Whether each entry is a center, stored as bytes to avoid the bit packing of std::vector<bool>.
+         */
+        std::vector<uint8_t> centerFlags;
+
+        /**
+         * Hash table with linear probing whose slots hold the position of an entry plus one, or zero if a slot is empty.
+         * The number of slots is a power of two and at least twice the number of entries.
+         */
+        std::vector<size_t> slots;
+
+        /**
+         * @brief Returns the position of an entry or `size()` if there is no such entry.
+         */
+        size_t
+        findPosition(size_t index, bool isCenter) const;
+
+        /**
+         * @brief Adds the weight to an existing entry or appends a new one.
+         * @returns The position of the entry.
+         */
+        size_t
+        addWeight(size_t index, bool isCenter, double weight);
+
+        /**
+         * @brief Replaces the hash table with one that has the given number of slots.
+         */
+        void
+        rehash(size_t numOfSlots);
 
     public:
         /**
@@ -47,11 +97,29 @@ namespace coresets
         void addCenter(size_t clusterIndex, double weight);
 
         /**
-         * Returns the coreset point at the given index.
+         * Returns a copy of the coreset point at the given index.
          */
         std::shared_ptr<WeightedPoint>
         at(size_t index) const;
 
+        /**
+         * @brief Returns the data point or cluster index of the coreset point at the given index.
+         */
+        size_t
+        getIndex(size_t index) const;
+
+        /**
+         * @brief Returns the weight of the coreset point at the given index.
+         */
+        double
+        getWeight(size_t index) const;
+
+        /**
+         * @brief Returns whether the coreset point at the given index is a center.
+         */
+        bool
+        isCenter(size_t index) const;
+
         /**
          * @brief Returns the number of points in this coreset.
          */
@@ -62,9 +130,24 @@ namespace coresets
          * @brief Finds a point by its index.
          * @param index The index to search for.
          * @param isCenter Whether to look for a center point.
-         * @returns An object or `nullptr` if no point found.
+         * @returns A copy of the point or `nullptr` if no point found.
          */
         std::shared_ptr<WeightedPoint>
-        findPoint(size_t index, bool isCenter = false);
+        findPoint(size_t index, bool isCenter = false) const;
+
+        /**
+         * @brief Gathers the points of the coreset into a contiguous matrix with one weight per row.
+         *
+         * Row i holds the data point or the centroid of the coreset point `at(i)`. The rows are
+         * copied in parallel and the source rows are prefetched ahead of the copies.
+         *
+         * @param data The NxD data matrix which the coreset was built from.
+         * @param result The clustering whose centroids the center points of the coreset refer to.
+         * @param numThreads The number of threads used to copy the rows. Zero means one thread per hardware core.
+         * @throws std::invalid_argument if a point or a center of the coreset is not in the data or the clustering.
+         */
+        template <typename T>
+        std::shared_ptr<WeightedMatrix<T>>
+        materialise(const blaze::DynamicMatrix<T> &data, const std::shared_ptr<clustering::ClusteringResult> result, size_t numThreads = 1) const;
     };
 }
@@ -2,13 +2,18 @@
 
 #include <algorithm>
 #include <cmath>
+#include <iomanip>
 #include <iostream>
+#include <memory>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
 #include <clustering/clustering_result.hpp>
 #include <clustering/kmeans.hpp>
 #include <coresets/coreset.hpp>
+#include <utils/logging.hpp>
+#include <utils/parallel.hpp>
 #include <utils/random.hpp>
 
 namespace coresets
@@ -42,6 +47,103 @@ namespace coresets
         ClusteredPoint &operator=(const ClusteredPoint &) = delete; // Disallow assignment
     };
 
+    /**
+     * @brief Struct-of-arrays storage for points with their clusters and costs.
+     *
+     * Rings and groups refer to contiguous ranges of an arena instead of allocating each of their points separately.
+     */
+    class ClusteredPointArena
+    {
+    public:
+        void
+        reserve(size_t capacity)
+        {
+            pointIndices.reserve(capacity);
+            clusterIndices.reserve(capacity);
+            costs.reserve(capacity);
+        }
+
+        /**
+         * @brief Resizes the arena so its points can be filled in any order with `set`.
+         */
+        void
+        resize(size_t numberOfPoints)
+        {
+            pointIndices.resize(numberOfPoints);
+            clusterIndices.resize(numberOfPoints);
+            costs.resize(numberOfPoints);
+        }
+
+        void
+        add(size_t pointIndex, size_t clusterIndex, double cost)
+        {
+            pointIndices.push_back(pointIndex);
+            clusterIndices.push_back(clusterIndex);
+            costs.push_back(cost);
+        }
+
+        void
+        set(size_t position, size_t pointIndex, size_t clusterIndex, double cost)
+        {
+            pointIndices[position] = pointIndex;
+            clusterIndices[position] = clusterIndex;
+            costs[position] = cost;
+        }
+
+        size_t
+        size() const
+        {
+            return pointIndices.size();
+        }
+
+        ClusteredPoint
+        at(size_t position) const
+        {
+            return ClusteredPoint(pointIndices[position], clusterIndices[position], costs[position]);
+        }
+
+        size_t getPointIndex(size_t position) const { return pointIndices[position]; }
+        size_t getClusterIndex(size_t position) const { return clusterIndices[position]; }
+        double getCost(size_t position) const { return costs[position]; }
+
+    private:
+        std::vector<size_t> pointIndices;
+        std::vector<size_t> clusterIndices;
+        std::vector<double> costs;
+    };
+
+    /**
+     * @brief A view of a contiguous range of points in an arena.
+     */
+    class ClusteredPointRange
+    {
+    public:
+        ClusteredPointRange(std::shared_ptr<const ClusteredPointArena> pointArena, size_t begin, size_t end) : Begin(begin), End(end), arena(pointArena)
+        {
+        }
+
+        size_t
+        size() const
+        {
+            return End - Begin;
+        }
+
+        ClusteredPoint
+        operator[](size_t index) const
+        {
+            return arena->at(Begin + index);
+        }
+
+        size_t getPointIndex(size_t index) const { return arena->getPointIndex(Begin + index); }
+        size_t getClusterIndex(size_t index) const { return arena->getClusterIndex(Begin + index); }
+        double getCost(size_t index) const { return arena->getCost(Begin + index); }
+
+    private:
+        const size_t Begin;
+        const size_t End;
+        std::shared_ptr<const ClusteredPointArena> arena;
+    };
+
     /**
      * Represents a group which is uniquely identified by its range value (j) and its ring range value (l) i.e., G_{j,l}
      */
@@ -69,33 +171,53 @@ namespace coresets
          */
         const double UpperBoundCost;
 
-        Group(size_t rangeValue, int ringRangeValue, double lowerBoundCost, double upperBoundCost) : RangeValue(rangeValue), RingRangeValue(ringRangeValue), LowerBoundCost(lowerBoundCost), UpperBoundCost(upperBoundCost)
+        /**
+         * @param groupPoints The arena which the points of this group are appended to. The group starts at the end of the arena.
+         */
+        Group(size_t rangeValue, int ringRangeValue, double lowerBoundCost, double upperBoundCost, std::shared_ptr<ClusteredPointArena> groupPoints) : RangeValue(rangeValue), RingRangeValue(ringRangeValue), LowerBoundCost(lowerBoundCost), UpperBoundCost(upperBoundCost),
+                                                                                                                                                  points(groupPoints), begin(groupPoints->size()), end(groupPoints->size()), totalCost(0.0)
         {
         }
 
         Group &operator=(const Group &) = delete; // Disallow assignment
 
+        /**
+         * @brief Appends a point to the group, which must be the last group that was created in its arena.
+         */
         void addPoint(size_t point, size_t cluster, double cost)
         {
-            points.push_back(std::make_shared<ClusteredPoint>(point, cluster, cost));
+            if (end != points->size())
+            {
+                throw std::logic_error("Points can only be added to the last group of an arena.");
+            }
+
+            points->add(point, cluster, cost);
+            end++;
+            totalCost += cost;
+
+            if (clusterCounts.empty() || clusterCounts.back().first != cluster)
+            {
+                clusterCounts.emplace_back(cluster, 0);
+            }
+            clusterCounts.back().second++;
         }
 
-        const std::vector<std::shared_ptr<ClusteredPoint>> &
+        ClusteredPointRange
         getPoints() const
         {
-            return points;
+            return ClusteredPointRange(points, begin, end);
+        }
+
+        size_t
+        countPoints() const
+        {
+            return end - begin;
         }
 
         double
         calcTotalCost() const
         {
-            double sum = 0;
-            for (size_t i = 0; i < points.size(); i++)
-            {
-                sum += points[i]->Cost;
-            }
-
-            return sum;
+            return totalCost;
         }
 
         /**
@@ -105,11 +227,11 @@ namespace coresets
         countPointsInCluster(size_t clusterIndex) const
         {
             size_t count = 0;
-            for (size_t i = 0; i < points.size(); i++)
+            for (auto &&clusterCount : clusterCounts)
             {
-                if (points[i]->ClusterIndex == clusterIndex)
+                if (clusterCount.first == clusterIndex)
                 {
-                    count++;
+                    count += clusterCount.second;
                 }
             }
             return count;
@@ -117,27 +239,58 @@ namespace coresets
 
     private:
         /**
-         * The points assigned to this group.
+         * The arena holding the points of this group in [begin, end).
          */
-        std::vector<std::shared_ptr<ClusteredPoint>> points;
+        std::shared_ptr<ClusteredPointArena> points;
+
+        size_t begin;
+
+        size_t end;
+
+        /**
+         * The sum of the costs of the points in this group.
+         */
+        double totalCost;
+
+        /**
+         * The number of points in each run of consecutive points of the same cluster. The groups of
+         * `GroupSampling` only hold points of one cluster, so there is a single run per group.
+         */
+        std::vector<std::pair<size_t, size_t>> clusterCounts;
     };
 
     class GroupSet
     {
         std::vector<std::shared_ptr<Group>> groups;
 
+        /**
+         * The points of all groups, each group occupies a contiguous range.
+         */
+        std::shared_ptr<ClusteredPointArena> points;
+
     public:
         const size_t GroupRangeSize;
 
-        GroupSet(size_t groupRangeSize) : GroupRangeSize(groupRangeSize)
+        GroupSet(size_t groupRangeSize) : points(std::make_shared<ClusteredPointArena>()), GroupRangeSize(groupRangeSize)
         {
         }
 
         GroupSet &operator=(const GroupSet &) = delete; // Disallow assignment
 
+        /**
+         * @brief Reserves space for the given number of points in all groups.
+         */
+        void reserve(size_t numberOfPoints)
+        {
+            points->reserve(numberOfPoints);
+        }
+
+        /**
+         * @brief Creates a group. Points are added to the group before the next group is created.
+         */
         std::shared_ptr<Group> create(size_t rangeValue, int ringRangeValue, double lowerBoundCost, double upperBoundCost)
         {
-            auto group = std::make_shared<Group>(rangeValue, ringRangeValue, lowerBoundCost, upperBoundCost);
+            auto group = std::make_shared<Group>(rangeValue, ringRangeValue, lowerBoundCost, upperBoundCost, points);
             groups.push_back(group);
             return group;
         }
@@ -175,24 +328,6 @@ namespace coresets
         }
     };
 
-    /**
-     * Represents a point that is not captured by any ring. 
-     */
-    struct RinglessPoint
-    {
-        const size_t PointIndex;
-        const size_t ClusterIndex;
-        const double PointCost;
-        const double CostBoundary;
-        const bool IsOvershot;
-
-        RinglessPoint(size_t postIndex, size_t clusterIndex, double pointCost, double costBoundary, bool isOvershot) : PointIndex(postIndex), ClusterIndex(clusterIndex), PointCost(pointCost), CostBoundary(costBoundary), IsOvershot(isOvershot)
-        {
-        }
-
-        RinglessPoint &operator=(const RinglessPoint &) = delete; // Disallow assignment
-    };
-
     class Ring
     {
     public:
@@ -225,59 +360,58 @@ namespace coresets
         Ring &operator=(const Ring &) = delete; // Disallow assignment
 
         /**
-         * @brief Adds a point to the ring if its costs is within the bounds of this ring.
-         * @param pointIndex The index of the point to add to this ring.
-         * @param cost The cost of the point i.e., cost(p, A)
-         * @return `true` if points is added to the ring, otherwise `false`
+         * @brief Sets the range of the arena which holds the points of this ring and sums up their costs.
          */
-        bool
-        tryAddPoint(size_t pointIndex, double cost)
+        void
+        setPoints(std::shared_ptr<const ClusteredPointArena> arena, size_t begin, size_t end)
         {
-            if (isCostWithinBounds(cost))
-            {
-                printf("Ring Point %3ld with cost(p, A) = %0.4f  ->  R[%2d, %ld]  [%0.4f, %0.4f) \n",
-                       pointIndex, cost, RangeValue, ClusterIndex, LowerBoundCost, UpperBoundCost);
+            points = arena;
+            firstPoint = begin;
+            lastPoint = end;
 
-                points.push_back(std::make_shared<ClusteredPoint>(pointIndex, ClusterIndex, cost));
-                TotalCost += cost;
-                return true;
+            TotalCost = 0.0;
+            for (size_t i = begin; i < end; i++)
+            {
+                TotalCost += arena->getCost(i);
             }
-
-            return false;
         }
 
         bool
-        isCostWithinBounds(double cost)
+        isCostWithinBounds(double cost) const
         {
             // If cost(p, A) is between Δ_c*2^l and Δ_c*2^(l+1) ...
             return cost >= LowerBoundCost && cost < UpperBoundCost;
         }
 
-        double getLowerBoundCost() { return LowerBoundCost; }
-        double getUpperBoundCost() { return UpperBoundCost; }
+        double getLowerBoundCost() const { return LowerBoundCost; }
+        double getUpperBoundCost() const { return UpperBoundCost; }
 
         /**
          * @brief Sums the costs of all points in captured by this ring.
          */
         double getTotalCost() { return TotalCost; }
 
-        const std::vector<std::shared_ptr<ClusteredPoint>> &
+        ClusteredPointRange
         getPoints() const
         {
-            return this->points;
+            return ClusteredPointRange(points, firstPoint, lastPoint);
         }
 
         size_t
         countPoints() const
         {
-            return this->points.size();
+            return lastPoint - firstPoint;
         }
 
     private:
         /**
-         * The points assigned to this ring.
+         * The arena holding the points of this ring in [firstPoint, lastPoint).
          */
-        std::vector<std::shared_ptr<ClusteredPoint>> points;
+        std::shared_ptr<const ClusteredPointArena> points;
+
+        size_t firstPoint = 0;
+
+        size_t lastPoint = 0;
 
         double LowerBoundCost;
 
@@ -289,66 +423,204 @@ namespace coresets
         double TotalCost;
     };
 
+    /**
+     * @brief The rings of all clusters, stored in a dense grid with one row of rings per cluster.
+     *
+     * All k * L rings are created up front, so a ring is looked up in O(1) by its cluster and range value.
+     */
     class RingSet
     {
+        /**
+         * The rings in row-major order, i.e., ring (c, l) is at index c * L + (l - RangeStart).
+         */
         std::vector<std::shared_ptr<Ring>> rings;
-        std::vector<std::shared_ptr<RinglessPoint>> overshotPoints;
-        std::vector<std::shared_ptr<RinglessPoint>> shortfallPoints;
+
+        /**
+         * The points of all rings ordered by ring, each ring occupies a contiguous range.
+         */
+        std::shared_ptr<ClusteredPointArena> ringPoints;
+
+        /**
+         * The overshot points ordered by cluster, cluster c occupies [overshotOffsets[c], overshotOffsets[c+1]).
+         */
+        std::shared_ptr<ClusteredPointArena> overshotPoints;
+        std::vector<size_t> overshotOffsets;
+
+        /**
+         * The shortfall points ordered by cluster, cluster c occupies [shortfallOffsets[c], shortfallOffsets[c+1]).
+         */
+        std::shared_ptr<ClusteredPointArena> shortfallPoints;
+        std::vector<size_t> shortfallOffsets;
+
+        /**
+         * The cost of the overshot points of each cluster and of all clusters.
+         */
+        std::vector<double> overshotClusterCosts;
+        double overshotCost = 0.0;
 
     public:
         const int RangeStart;
         const int RangeEnd;
         const size_t NumberOfClusters;
 
-        RingSet(int start, int end, size_t numberOfClusters) : RangeStart(start), RangeEnd(end), NumberOfClusters(numberOfClusters)
+        /**
+         * @brief Creates the rings of all clusters.
+         * @param start The smallest ring range value.
+         * @param end The largest ring range value.
+         * @param averageClusterCosts The average cost of each cluster i.e. Δ_c
+         */
+        RingSet(int start, int end, const blaze::DynamicVector<double> &averageClusterCosts) : ringPoints(std::make_shared<ClusteredPointArena>()),
+                                                                                              overshotPoints(std::make_shared<ClusteredPointArena>()),
+                                                                                              overshotOffsets(averageClusterCosts.size() + 1, 0),
+                                                                                              shortfallPoints(std::make_shared<ClusteredPointArena>()),
+                                                                                              shortfallOffsets(averageClusterCosts.size() + 1, 0),
+                                                                                              overshotClusterCosts(averageClusterCosts.size(), 0.0),
+                                                                                              RangeStart(start), RangeEnd(end), NumberOfClusters(averageClusterCosts.size())
         {
+            const size_t numberOfRanges = static_cast<size_t>(end - start + 1);
+            rings.reserve(NumberOfClusters * numberOfRanges);
+            for (size_t c = 0; c < NumberOfClusters; c++)
+            {
+                for (int l = start; l <= end; l++)
+                {
+                    rings.push_back(std::make_shared<Ring>(c, l, averageClusterCosts[c]));
+                }
+            }
         }
 
         RingSet &operator=(const RingSet &) = delete; // Disallow assignment
 
+        /**
+         * @brief Returns the ring of a cluster for a range value, or `nullptr` if the range value is out of range.
+         */
         std::shared_ptr<Ring> find(size_t clusterIndex, int rangeValue) const
         {
-            for (size_t i = 0; i < rings.size(); i++)
+            if (clusterIndex >= NumberOfClusters || rangeValue < RangeStart || rangeValue > RangeEnd)
             {
-                auto ring = rings[i];
-                if (ring->ClusterIndex == clusterIndex && ring->RangeValue == rangeValue)
-                {
-                    return ring;
-                }
+                return nullptr;
             }
-            return nullptr;
+            return rings[getRingIndex(clusterIndex, rangeValue)];
         }
 
-        std::shared_ptr<Ring> findOrCreate(size_t clusterIndex, int rangeValue, double averageClusterCost)
+        /**
+         * @brief Returns the range value l of the ring of a cluster which captures a cost, i.e., Δ_c*2^l <= cost < Δ_c*2^(l+1).
+         *
+         * The range value is computed from log2(cost/Δ_c) in O(1) and then checked against the bounds of
+         * the rings, so rounding in the logarithm cannot put a cost on the wrong side of a bound.
+         *
+         * @return `RangeStart - 1` if the cost is below the inner most ring and `RangeEnd + 1` if it is not below the
+         * upper bound of the outer most ring.
+         */
+        int
+        findRangeValue(size_t clusterIndex, double cost) const
         {
-            auto ring = find(clusterIndex, rangeValue);
-            if (ring == nullptr)
+            const auto &innerMostRing = rings[getRingIndex(clusterIndex, RangeStart)];
+            const auto &outerMostRing = rings[getRingIndex(clusterIndex, RangeEnd)];
+            if (cost < innerMostRing->getLowerBoundCost())
+            {
+                return RangeStart - 1;
+            }
+            if (cost >= outerMostRing->getUpperBoundCost())
             {
-                // printf("Ring for cluster=%ld and l=%2d not found. Creating...\n", clusterIndex, rangeValue);
-                ring = std::make_shared<Ring>(clusterIndex, rangeValue, averageClusterCost);
-                rings.push_back(ring);
+                return RangeEnd + 1;
             }
-            return ring;
+
+            // Between the inner most and the outer most bound both the cost and Δ_c are positive.
+            const double ratio = cost / innerMostRing->AverageClusterCost;
+            int l = std::min(RangeEnd, std::max(RangeStart, static_cast<int>(std::floor(std::log2(ratio)))));
+            while (l > RangeStart && cost < rings[getRingIndex(clusterIndex, l)]->getLowerBoundCost())
+            {
+                l--;
+            }
+            while (l < RangeEnd && cost >= rings[getRingIndex(clusterIndex, l)]->getUpperBoundCost())
+            {
+                l++;
+            }
+            return l;
         }
 
-        void addOvershotPoint(size_t pointIndex, size_t clusterIndex, double cost, double costBoundary)
+        /**
+         * @brief Puts all points into the rings of their clusters or among the shortfall or overshot points.
+         *
+         * The points are bucketed with a counting sort, so every ring and the ringless points of every
+         * cluster occupy a contiguous range of an arena, in the order of the points.
+         *
+         * @param clusters The cluster assignments of the points.
+         * @param rangeValues The range value of each point as returned by `findRangeValue`.
+         */
+        void addPoints(const clustering::ClusterAssignmentList &clusters, const std::vector<int> &rangeValues)
         {
-            printf("Overshot Point %3ld with cost(p, A) = %0.4f cluster(p)=%ld -> the cost(p, A) ",
-                   pointIndex, cost, clusterIndex);
-            printf("is above the cost range of outer most ring (%.4f)\n", costBoundary);
+            const size_t n = clusters.getNumberOfPoints();
+            std::vector<size_t> ringOffsets(rings.size() + 1, 0);
 
-            auto point = std::make_shared<RinglessPoint>(pointIndex, clusterIndex, cost, costBoundary, true);
-            overshotPoints.push_back(point);
-        }
+            for (size_t p = 0; p < n; p++)
+            {
+                const size_t c = clusters.getCluster(p);
+                const int l = rangeValues[p];
+                if (l < RangeStart)
+                {
+                    shortfallOffsets[c + 1]++;
+                }
+                else if (l > RangeEnd)
+                {
+                    overshotOffsets[c + 1]++;
+                }
+                else
+                {
+                    ringOffsets[getRingIndex(c, l) + 1]++;
+                }
+            }
 
-        void addShortfallPoint(size_t pointIndex, size_t clusterIndex, double cost, double costBoundary)
-        {
-            printf("Shortfall Point %3ld with cost(p, A) = %0.4f cluster(p)=%ld -> the cost(p, A) ",
-                   pointIndex, cost, clusterIndex);
-            printf("falls below the cost range of inner most ring (%.4f)\n", costBoundary);
+            for (size_t i = 0; i < rings.size(); i++)
+            {
+                ringOffsets[i + 1] += ringOffsets[i];
+            }
+            for (size_t c = 0; c < NumberOfClusters; c++)
+            {
+                shortfallOffsets[c + 1] += shortfallOffsets[c];
+                overshotOffsets[c + 1] += overshotOffsets[c];
+            }
+
+            ringPoints->resize(ringOffsets.back());
+            shortfallPoints->resize(shortfallOffsets.back());
+            overshotPoints->resize(overshotOffsets.back());
 
-            auto point = std::make_shared<RinglessPoint>(pointIndex, clusterIndex, cost, costBoundary, false);
-            shortfallPoints.push_back(point);
+            std::vector<size_t> ringCursors(ringOffsets.begin(), ringOffsets.end() - 1);
+            std::vector<size_t> shortfallCursors(shortfallOffsets.begin(), shortfallOffsets.end() - 1);
+            std::vector<size_t> overshotCursors(overshotOffsets.begin(), overshotOffsets.end() - 1);
+
+            for (size_t p = 0; p < n; p++)
+            {
+                const size_t c = clusters.getCluster(p);
+                const double cost = clusters.getPointCost(p);
+                const int l = rangeValues[p];
+                if (l < RangeStart)
+                {
+                    KMEANS_LOG_TRACE("Shortfall Point %3ld with cost(p, A) = %0.4f cluster(p)=%ld -> the cost(p, A) falls below the cost range of inner most ring (%.4f)",
+                                     p, cost, c, rings[getRingIndex(c, RangeStart)]->getLowerBoundCost());
+                    shortfallPoints->set(shortfallCursors[c]++, p, c, cost);
+                }
+                else if (l > RangeEnd)
+                {
+                    KMEANS_LOG_TRACE("Overshot Point %3ld with cost(p, A) = %0.4f cluster(p)=%ld -> the cost(p, A) is above the cost range of outer most ring (%.4f)",
+                                     p, cost, c, rings[getRingIndex(c, RangeEnd)]->getUpperBoundCost());
+                    overshotPoints->set(overshotCursors[c]++, p, c, cost);
+                    overshotClusterCosts[c] += cost;
+                    overshotCost += cost;
+                }
+                else
+                {
+                    const size_t ringIndex = getRingIndex(c, l);
+                    KMEANS_LOG_TRACE("Ring Point %3ld with cost(p, A) = %0.4f  ->  R[%2d, %ld]  [%0.4f, %0.4f)",
+                                     p, cost, l, c, rings[ringIndex]->getLowerBoundCost(), rings[ringIndex]->getUpperBoundCost());
+                    ringPoints->set(ringCursors[ringIndex]++, p, c, cost);
+                }
+            }
+
+            for (size_t i = 0; i < rings.size(); i++)
+            {
+                rings[i]->setPoints(ringPoints, ringOffsets[i], ringOffsets[i + 1]);
+            }
         }
 
         /**
@@ -359,13 +631,9 @@ namespace coresets
         calcRingCost(int ringRangeValue) const
         {
             double sum = 0.0F;
-            for (size_t i = 0; i < rings.size(); i++)
+            for (size_t c = 0; c < NumberOfClusters; c++)
             {
-                auto ring = rings[i];
-                if (ring->RangeValue == ringRangeValue)
-                {
-                    sum += ring->getTotalCost();
-                }
+                sum += rings[getRingIndex(c, ringRangeValue)]->getTotalCost();
             }
             return sum;
         }
@@ -378,13 +646,9 @@ namespace coresets
         countRingPoints(int ringRangeValue) const
         {
             size_t count = 0;
-            for (size_t i = 0; i < rings.size(); i++)
+            for (size_t c = 0; c < NumberOfClusters; c++)
             {
-                auto ring = rings[i];
-                if (ring->RangeValue == ringRangeValue)
-                {
-                    count += ring->countPoints();
-                }
+                count += rings[getRingIndex(c, ringRangeValue)]->countPoints();
             }
             return count;
         }
@@ -396,16 +660,7 @@ namespace coresets
         size_t
         getNumberOfShortfallPoints(size_t clusterIndex) const
         {
-            size_t count = 0;
-            for (size_t i = 0; i < shortfallPoints.size(); i++)
-            {
-                auto point = shortfallPoints[i];
-                if (point->ClusterIndex == clusterIndex)
-                {
-                    count++;
-                }
-            }
-            return count;
+            return shortfallOffsets[clusterIndex + 1] - shortfallOffsets[clusterIndex];
         }
 
         /**
@@ -415,43 +670,31 @@ namespace coresets
         double
         computeCostOfOvershotPoints(int clusterIndex = -1) const
         {
-            double cost = 0.0;
-            for (size_t i = 0; i < this->overshotPoints.size(); i++)
+            if (clusterIndex < 0)
             {
-                auto point = this->overshotPoints.at(i);
-
-                if (clusterIndex == -1 || (clusterIndex >= 0 && point->ClusterIndex == clusterIndex))
-                {
-                    cost += point->PointCost;
-                }
+                return overshotCost;
             }
 
-            return cost;
+            return overshotClusterCosts[static_cast<size_t>(clusterIndex)];
         }
 
-        /**
-         * @brief Computes the cost of  points in a given cluster.
-         * @param clusterIndex The cluster for which to compute cost.
-         */
-        double
-        computeCostOfPoints(size_t clusterIndex) const
+        ClusteredPointRange
+        getOvershotPoints(size_t clusterIndex) const
         {
-            return computeCostOfPoints(static_cast<int>(clusterIndex));
+            return ClusteredPointRange(overshotPoints, overshotOffsets[clusterIndex], overshotOffsets[clusterIndex + 1]);
         }
 
-        std::vector<std::shared_ptr<RinglessPoint>>
-        getOvershotPoints(size_t clusterIndex) const
+        ClusteredPointRange
+        getShortfallPoints(size_t clusterIndex) const
         {
-            std::vector<std::shared_ptr<RinglessPoint>> filteredPoints;
-            for (size_t i = 0; i < this->overshotPoints.size(); i++)
-            {
-                auto point = this->overshotPoints.at(i);
-                if (point->ClusterIndex == clusterIndex)
-                {
-                    filteredPoints.push_back(point);
-                }
-            }
-            return filteredPoints;
+            return ClusteredPointRange(shortfallPoints, shortfallOffsets[clusterIndex], shortfallOffsets[clusterIndex + 1]);
+        }
+
+    private:
+        size_t
+        getRingIndex(size_t clusterIndex, int rangeValue) const
+        {
+            return clusterIndex * static_cast<size_t>(RangeEnd - RangeStart + 1) + static_cast<size_t>(rangeValue - RangeStart);
         }
     };
 
@@ -483,17 +726,38 @@ namespace coresets
          */
         const size_t GroupRangeSize;
 
-        GroupSampling(size_t numberOfClusters, size_t targetSamplesInCoreset, size_t beta, size_t groupRangeSize, size_t minimumGroupSamplingSize);
+        /**
+         * The number of threads used to put the points into rings.
+         */
+        const size_t NumThreads;
 
+        /**
+         * @param numThreads The number of threads used to put the points into rings. Zero means one thread per hardware core.
+         */
+        GroupSampling(size_t numberOfClusters, size_t targetSamplesInCoreset, size_t beta, size_t groupRangeSize, size_t minimumGroupSamplingSize, size_t numThreads = 1);
+
+        template <typename T>
         std::shared_ptr<Coreset>
-        run(const blaze::DynamicMatrix<double> &data);
+        run(const blaze::DynamicMatrix<T> &data);
 
         std::shared_ptr<Coreset>
         run(const std::shared_ptr<clustering::ClusteringResult> result);
 
+        /**
+         * @brief Saves checkpoints of the k-Means clustering which the coreset is built from, and resumes it from the file if it exists.
+         * @param filePath The path of the checkpoint file. An empty path disables checkpoints.
+         * @param interval The number of k-Means iterations between two checkpoints.
+         */
+        void
+        enableCheckpoints(const std::string &filePath, size_t interval = 1);
+
     private:
         utils::Random random;
 
+        std::string checkpointPath;
+
+        size_t checkpointInterval = 1;
+
         std::shared_ptr<RingSet>
         makeRings(const clustering::ClusterAssignmentList &clusters);
 
@@ -6,6 +6,7 @@
 
 #include <clustering/kmeans.hpp>
 #include <coresets/coreset.hpp>
+#include <utils/logging.hpp>
 #include <utils/random.hpp>
 
 namespace coresets
@@ -25,12 +26,31 @@ namespace coresets
 
         SensitivitySampling(size_t numberOfClusters, size_t targetSamplesInCoreset);
 
+        template <typename T>
         std::shared_ptr<Coreset>
-        run(const blaze::DynamicMatrix<double> &data);
+        run(const blaze::DynamicMatrix<T> &data);
+
+        /**
+         * @brief Builds the coreset from an existing clustering, e.g., to materialise it against the same centroids.
+         */
+        std::shared_ptr<Coreset>
+        run(const std::shared_ptr<clustering::ClusteringResult> result);
+
+        /**
+         * @brief Saves checkpoints of the k-Means clustering which the coreset is built from, and resumes it from the file if it exists.
+         * @param filePath The path of the checkpoint file. An empty path disables checkpoints.
+         * @param interval The number of k-Means iterations between two checkpoints.
+         */
+        void
+        enableCheckpoints(const std::string &filePath, size_t interval = 1);
 
     private:
         utils::Random random;
 
+        std::string checkpointPath;
+
+        size_t checkpointInterval = 1;
+
         std::shared_ptr<Coreset>
         generateCoresetPoints(const clustering::ClusterAssignmentList &clusterAssignments);
 
@@ -23,10 +23,29 @@ namespace coresets
 
         StreamKMeans(size_t targetSamplesInCoreset);
 
+        template <typename T>
         std::shared_ptr<Coreset>
-        run(const blaze::DynamicMatrix<double> &data);
+        run(const blaze::DynamicMatrix<T> &data);
+
+        /**
+         * @brief Builds the coreset from an existing clustering with T clusters, e.g., to materialise it against the same centroids.
+         */
+        std::shared_ptr<Coreset>
+        run(const std::shared_ptr<clustering::ClusteringResult> result);
+
+        /**
+         * @brief Saves checkpoints of the k-Means clustering which the coreset is built from, and resumes it from the file if it exists.
+         * @param filePath The path of the checkpoint file. An empty path disables checkpoints.
+         * @param interval The number of k-Means iterations between two checkpoints.
+         */
+        void
+        enableCheckpoints(const std::string &filePath, size_t interval = 1);
 
     private:
         utils::Random random;
+
+        std::string checkpointPath;
+
+        size_t checkpointInterval = 1;
     };
 }
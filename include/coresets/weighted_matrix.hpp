@@ -0,0 +1,67 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <blaze/Math.h>
+
+namespace coresets
+{
+    /**
+     * @brief A coreset materialised as a contiguous row-major matrix of points with one weight per row.
+     *
+     * The points and weights can be clustered directly with `KMeans::run(points, weights)`.
+     *
+     * @tparam T The scalar type of the points, float or double.
+     */
+    template <typename T = double>
+    class WeightedMatrix
+    {
+    public:
+        /**
+         * @brief Creates a new instance of WeightedMatrix.
+         * @param points A TxD matrix with one coreset point per row.
+         * @param weights The weight of each of the T points.
+         * @throws std::invalid_argument if the number of weights is not the number of points.
+         */
+        WeightedMatrix(blaze::DynamicMatrix<T> points, blaze::DynamicVector<double> weights);
+
+        const blaze::DynamicMatrix<T> &
+        getPoints() const;
+
+        const blaze::DynamicVector<double> &
+        getWeights() const;
+
+        /**
+         * @brief Returns the number of points.
+         */
+        size_t
+        size() const;
+
+        /**
+         * @brief Writes the points and the weights in binary format.
+         *
+         * The format holds the number of points, the number of dimensions and the size of the scalar
+         * type, followed by the weights and the points in row-major order. Values are stored in the
+         * byte order of the machine.
+         */
+        void
+        save(std::ostream &stream) const;
+
+        /**
+         * @brief Reads points and weights written by `save`.
+         * @throws std::runtime_error if the stream does not contain a weighted matrix with scalars of type T.
+         */
+        static std::shared_ptr<WeightedMatrix<T>>
+        load(std::istream &stream);
+
+    private:
+        blaze::DynamicMatrix<T> points;
+        blaze::DynamicVector<double> weights;
+    };
+}
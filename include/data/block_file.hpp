@@ -0,0 +1,120 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <blaze/Math.h>
+
+namespace data
+{
+    /**
+     * @brief Writes a dense data matrix to a binary block file row by row, so a dataset can be
+     * converted without holding it in memory.
+     *
+     * A block file starts with a header holding the number of rows, the number of columns and the
+     * size of the scalar type, followed by the rows in row-major order. Values are stored in the
+     * byte order of the machine, so a block file can only be read on a machine with the same byte order.
+     *
+     * @tparam T The scalar type of the stored values.
+     */
+    template <typename T = double>
+    class BlockFileWriter
+    {
+    public:
+        /**
+         * @brief Creates a new block file, replacing any existing file.
+         * @param filePath The path of the block file.
+         * @param numOfColumns The number of values in each row.
+         * @throws std::runtime_error if the file cannot be created.
+         */
+        BlockFileWriter(const std::string &filePath, size_t numOfColumns);
+
+        /**
+         * @brief Closes the file if `close` was not called.
+         */
+        ~BlockFileWriter();
+
+        BlockFileWriter(const BlockFileWriter &) = delete;
+
+        BlockFileWriter &operator=(const BlockFileWriter &) = delete;
+
+        /**
+         * @brief Appends a row with `numOfColumns` values.
+         */
+        void
+        appendRow(const std::vector<T> &values);
+
+        /**
+         * @brief Appends all the rows of a matrix with `numOfColumns` columns.
+         */
+        void
+        appendRows(const blaze::DynamicMatrix<T> &rows);
+
+        /**
+         * @brief Writes the number of rows to the header and closes the file.
+         * @throws std::runtime_error if the file could not be written.
+         */
+        void
+        close();
+
+        size_t
+        getNumberOfRows() const;
+
+    private:
+        const size_t NumOfColumns;
+
+        std::ofstream file;
+
+        size_t numOfRows = 0;
+
+        std::vector<T> buffer;
+    };
+
+    /**
+     * @brief Reads consecutive rows of a binary block file written by `BlockFileWriter`.
+     *
+     * The reader keeps a single file position, so it must only be used by one thread at a time.
+     *
+     * @tparam T The scalar type of the stored values.
+     */
+    template <typename T = double>
+    class BlockFileReader
+    {
+    public:
+        /**
+         * @brief Opens a block file and reads its header.
+         * @param filePath The path of the block file.
+         * @throws std::runtime_error if the file is not a block file with values of type `T`.
+         */
+        BlockFileReader(const std::string &filePath);
+
+        size_t
+        getNumberOfRows() const;
+
+        size_t
+        getNumberOfColumns() const;
+
+        /**
+         * @brief Reads consecutive rows into a matrix.
+         * @param firstRow The index of the first row to read.
+         * @param numOfRowsToRead The number of rows to read.
+         * @param block Receives the rows and is resized to `numOfRowsToRead` rows.
+         * @throws std::runtime_error if the rows could not be read.
+         */
+        void
+        readRows(size_t firstRow, size_t numOfRowsToRead, blaze::DynamicMatrix<T> &block);
+
+    private:
+        std::ifstream file;
+
+        size_t numOfRows;
+
+        size_t numOfColumns;
+
+        std::vector<T> buffer;
+    };
+}
@@ -17,13 +17,37 @@
 #include <boost/iostreams/filter/bzip2.hpp>
 
 #include <data/data_parser.hpp>
+#include <utils/logging.hpp>
 
 namespace data
 {
-    class BagOfWordsParser : public data::IDataParser
+    /**
+     * Parses the UCI bag-of-words datasets where each document is a row and each word is a column.
+     */
+    template <typename T = double>
+    class BagOfWordsParser : public data::IDataParser<T>, public data::ISparseDataParser<T>
     {
     public:
-        std::shared_ptr<blaze::DynamicMatrix<double>>
+        /**
+         * Parses the documents into a dense matrix. Prefer `parseSparse` for large vocabularies.
+         */
+        std::shared_ptr<blaze::DynamicMatrix<T>>
         parse(const std::string &filePath);
+
+        /**
+         * Parses the documents into a sparse matrix in compressed row (CSR) format.
+         */
+        std::shared_ptr<blaze::CompressedMatrix<T>>
+        parseSparse(const std::string &filePath);
+
+    private:
+        /**
+         * Reads the header and the (document, word, count) triples of the file.
+         * @param onSize Called with the number of documents, words and nonzero counts before any triple.
+         * @param onEntry Called with the zero-based row of the document, the zero-based word index and the count.
+         */
+        template <typename SizeCallback, typename EntryCallback>
+        void
+        readEntries(const std::string &filePath, SizeCallback onSize, EntryCallback onEntry);
     };
 }
@@ -16,14 +16,30 @@
 #include <boost/iostreams/filter/gzip.hpp>
 #include <boost/iostreams/filter/bzip2.hpp>
 
+#include <data/block_file.hpp>
 #include <data/data_parser.hpp>
+#include <utils/logging.hpp>
 
 namespace data
 {
-    class CovertypeParser : public data::IDataParser
+    template <typename T = double>
+    class CovertypeParser : public data::IDataParser<T>, public data::IBlockFileConverter<T>
     {
     public:
-        std::shared_ptr<blaze::DynamicMatrix<double>>
+        std::shared_ptr<blaze::DynamicMatrix<T>>
         parse(const std::string &filePath);
+
+        size_t
+        convertToBlockFile(const std::string &filePath, const std::string &blockFilePath);
+
+    private:
+        /**
+         * Reads the rows of the file one at a time.
+         * @param onSize Called with the expected number of rows and the number of columns before any row.
+         * @param onRow Called with the values of each row.
+         */
+        template <typename SizeCallback, typename RowCallback>
+        void
+        readRows(const std::string &filePath, SizeCallback onSize, RowCallback onRow);
     };
 }
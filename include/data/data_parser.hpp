@@ -12,7 +12,9 @@ namespace data
 {
     /**
      * Represents a data parser.
+     * @tparam T The scalar type of the parsed data matrix, float halves the memory used by the data.
      */
+    template <typename T = double>
     class IDataParser
     {
     public:
@@ -21,7 +23,44 @@ namespace data
         /**
          * Parses the given file and converts it into a data matrix.
          */
-        virtual std::shared_ptr<blaze::DynamicMatrix<double>>
+        virtual std::shared_ptr<blaze::DynamicMatrix<T>>
         parse(const std::string &filePath) = 0; // pure virtual method
     };
+
+    /**
+     * Represents a parser of sparse data, e.g., bag-of-words documents.
+     * @tparam T The scalar type of the nonzero entries.
+     */
+    template <typename T = double>
+    class ISparseDataParser
+    {
+    public:
+        virtual ~ISparseDataParser() {}
+
+        /**
+         * Parses the given file into a sparse matrix in compressed row (CSR) format, so only the
+         * nonzero entries are stored.
+         */
+        virtual std::shared_ptr<blaze::CompressedMatrix<T>>
+        parseSparse(const std::string &filePath) = 0;
+    };
+
+    /**
+     * Represents a parser which can convert a dataset into a block file row by row, so datasets
+     * which do not fit in memory can be clustered out of core, see `OutOfCoreKMeans`.
+     * @tparam T The scalar type of the values in the block file.
+     */
+    template <typename T = double>
+    class IBlockFileConverter
+    {
+    public:
+        virtual ~IBlockFileConverter() {}
+
+        /**
+         * Parses the given file and writes its rows to a block file without holding the data in memory.
+         * @return The number of rows written.
+         */
+        virtual size_t
+        convertToBlockFile(const std::string &filePath, const std::string &blockFilePath) = 0;
+    };
 }
@@ -0,0 +1,249 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <blaze/Math.h>
+
+#include <utils/logging.hpp>
+
+namespace utils
+{
+    /**
+     * @brief Named values which describe the state of an iterative algorithm between two iterations,
+     * e.g., its centroids, assignments, iteration counter and random state.
+     *
+     * Checkpoints are saved in a binary format in the byte order of the machine, so a checkpoint can
+     * only be read on a machine with the same byte order.
+     */
+    class Checkpoint
+    {
+    public:
+        void
+        setMatrix(const std::string &name, const blaze::DynamicMatrix<double> &value);
+
+        void
+        setVector(const std::string &name, const blaze::DynamicVector<double> &value);
+
+        void
+        setIndices(const std::string &name, const std::vector<size_t> &value);
+
+        void
+        setInteger(const std::string &name, size_t value);
+
+        void
+        setReal(const std::string &name, double value);
+
+        void
+        setText(const std::string &name, const std::string &value);
+
+        /**
+         * @throws std::out_of_range if there is no matrix with the given name.
+         */
+        blaze::DynamicMatrix<double>
+        getMatrix(const std::string &name) const;
+
+        /**
+         * @throws std::out_of_range if there is no vector with the given name.
+         */
+        blaze::DynamicVector<double>
+        getVector(const std::string &name) const;
+
+        /**
+         * @throws std::out_of_range if there are no indices with the given name.
+         */
+        std::vector<size_t>
+        getIndices(const std::string &name) const;
+
+        /**
+         * @throws std::out_of_range if there is no integer with the given name.
+         */
+        size_t
+        getInteger(const std::string &name) const;
+
+        /**
+         * @throws std::out_of_range if there is no real number with the given name.
+         */
+        double
+        getReal(const std::string &name) const;
+
+        /**
+         * @throws std::out_of_range if there is no text with the given name.
+         */
+        std::string
+        getText(const std::string &name) const;
+
+        bool
+        contains(const std::string &name) const;
+
+        /**
+         * @brief Copies all values of another checkpoint into this one, replacing values with the same names.
+         */
+        void
+        setAll(const Checkpoint &other);
+
+        /**
+         * @brief Returns whether this checkpoint holds every value of another checkpoint with the same type and contents.
+         */
+        bool
+        includes(const Checkpoint &other) const;
+
+        /**
+         * @brief Writes the checkpoint in binary format.
+         */
+        void
+        save(std::ostream &stream) const;
+
+        /**
+         * @brief Reads a checkpoint written by `save`.
+         * @throws std::runtime_error if the stream does not contain a valid checkpoint.
+         */
+        static std::shared_ptr<Checkpoint>
+        load(std::istream &stream);
+
+    private:
+        enum class ValueType : uint8_t
+        {
+            Matrix = 1,
+            Vector = 2,
+            Indices = 3,
+            Integer = 4,
+            Real = 5,
+            Text = 6
+        };
+
+        /**
+         * A value is kept as the raw bytes of its elements together with its shape.
+         */
+        struct Entry
+        {
+            ValueType Type;
+            uint64_t Rows;
+            uint64_t Columns;
+            std::string Bytes;
+        };
+
+        std::map<std::string, Entry> entries;
+
+        void
+        setEntry(const std::string &name, ValueType type, uint64_t rows, uint64_t columns, const void *data, size_t numOfBytes);
+
+        const Entry &
+        getEntry(const std::string &name, ValueType type) const;
+    };
+
+    /**
+     * @brief Reads the checkpoint stored in a file.
+     * @param filePath The path of the checkpoint file.
+     * @return The checkpoint or null if the path is empty or the file does not exist.
+     * @throws std::runtime_error if the file does not contain a valid checkpoint.
+     */
+    std::shared_ptr<Checkpoint>
+    readCheckpoint(const std::string &filePath);
+
+    /**
+     * @brief Deletes a checkpoint file, e.g., once the algorithm which wrote it has completed.
+     *
+     * Nothing happens if the path is empty or the file does not exist.
+     */
+    void
+    removeCheckpoint(const std::string &filePath);
+
+    /**
+     * @brief Returns a hash of the shape and the values of a matrix.
+     *
+     * Checkpoints store the fingerprint of the data they were computed on, so they are only resumed
+     * on the same data. Every value is read once.
+     */
+    template <typename T>
+    size_t
+    calcFingerprint(const blaze::DynamicMatrix<T> &matrix);
+
+    /**
+     * @brief Returns a hash of the shape, the nonzero positions and the nonzero values of a sparse matrix.
+     */
+    template <typename T>
+    size_t
+    calcFingerprint(const blaze::CompressedMatrix<T> &matrix);
+
+    /**
+     * @brief Returns a hash of the size and the values of a vector.
+     */
+    size_t
+    calcFingerprint(const blaze::DynamicVector<double> &vector);
+
+    /**
+     * @brief Writes checkpoints to a file on a background thread so the caller does not wait for the I/O.
+     *
+     * Only the latest checkpoint matters, so a checkpoint which is still waiting to be written is
+     * replaced by a newer one. Each checkpoint is written to a temporary file which is then renamed,
+     * so the file always contains a complete checkpoint even if the process is killed while writing.
+     */
+    class CheckpointWriter
+    {
+    public:
+        /**
+         * @brief Creates a new instance of CheckpointWriter.
+         * @param filePath The path of the checkpoint file.
+         */
+        CheckpointWriter(const std::string &filePath);
+
+        /**
+         * @brief Waits until the last checkpoint is written.
+         */
+        ~CheckpointWriter();
+
+        CheckpointWriter(const CheckpointWriter &) = delete;
+
+        CheckpointWriter &operator=(const CheckpointWriter &) = delete;
+
+        /**
+         * @brief Queues a checkpoint to be written and returns immediately.
+         */
+        void
+        write(std::shared_ptr<const Checkpoint> checkpoint);
+
+        /**
+         * @brief Waits until all queued checkpoints are written.
+         */
+        void
+        flush();
+
+        /**
+         * @brief Discards the queued checkpoint, waits for the checkpoint being written and deletes the file.
+         *
+         * Called once the algorithm has completed, so the next run with the same path starts from scratch.
+         */
+        void
+        remove();
+
+    private:
+        const std::string FilePath;
+
+        std::mutex mutex;
+
+        std::condition_variable changed;
+
+        std::shared_ptr<const Checkpoint> pending;
+
+        bool isWriting = false;
+
+        bool isStopping = false;
+
+        std::thread thread;
+
+        void
+        writeLoop();
+    };
+}
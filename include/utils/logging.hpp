@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstdarg>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+/**
+ * The lowest level of the messages which are compiled into the library: 0 = Trace, 1 = Debug,
+ * 2 = Info, 3 = Warning, 4 = Error and 5 = Off. Calls to the logging macros below this level are
+ * removed by the preprocessor, including the evaluation of their arguments.
+ */
+#ifndef KMEANS_LOG_LEVEL
+#define KMEANS_LOG_LEVEL 2
+#endif
+
+#if KMEANS_LOG_LEVEL <= 0
+#define KMEANS_LOG_TRACE(...) utils::log(utils::LogLevel::Trace, __VA_ARGS__)
+#else
+#define KMEANS_LOG_TRACE(...) ((void)0)
+#endif
+
+#if KMEANS_LOG_LEVEL <= 1
+#define KMEANS_LOG_DEBUG(...) utils::log(utils::LogLevel::Debug, __VA_ARGS__)
+#else
+#define KMEANS_LOG_DEBUG(...) ((void)0)
+#endif
+
+#if KMEANS_LOG_LEVEL <= 2
+#define KMEANS_LOG_INFO(...) utils::log(utils::LogLevel::Info, __VA_ARGS__)
+#else
+#define KMEANS_LOG_INFO(...) ((void)0)
+#endif
+
+#if KMEANS_LOG_LEVEL <= 3
+#define KMEANS_LOG_WARNING(...) utils::log(utils::LogLevel::Warning, __VA_ARGS__)
+#else
+#define KMEANS_LOG_WARNING(...) ((void)0)
+#endif
+
+#if KMEANS_LOG_LEVEL <= 4
+#define KMEANS_LOG_ERROR(...) utils::log(utils::LogLevel::Error, __VA_ARGS__)
+#else
+#define KMEANS_LOG_ERROR(...) ((void)0)
+#endif
+
+namespace utils
+{
+    /**
+     * @brief The severity of a log message.
+     */
+    enum class LogLevel
+    {
+        /**
+         * Per point or per swap messages, e.g., every point added to a coreset.
+         */
+        Trace = 0,
+
+        /**
+         * Per iteration messages, e.g., the centroid shift of each iteration of Lloyd's algorithm.
+         */
+        Debug = 1,
+
+        /**
+         * Progress of the algorithms and the parsers.
+         */
+        Info = 2,
+
+        /**
+         * Unexpected input which is skipped.
+         */
+        Warning = 3,
+
+        /**
+         * Failures.
+         */
+        Error = 4,
+
+        /**
+         * Disables all messages.
+         */
+        Off = 5
+    };
+
+    /**
+     * @brief Represents the destination of log messages.
+     */
+    class ILogSink
+    {
+    public:
+        virtual ~ILogSink() {}
+
+        /**
+         * @brief Writes a message. Calls are serialised by the logger so sinks do not need to be thread-safe.
+         * @param level The severity of the message.
+         * @param message The message which may span several lines, without a trailing newline.
+         */
+        virtual void
+        write(LogLevel level, const std::string &message) = 0;
+    };
+
+    /**
+     * @brief Writes each message as a line to the standard output.
+     */
+    class StdoutLogSink : public ILogSink
+    {
+    public:
+        void
+        write(LogLevel level, const std::string &message);
+    };
+
+    /**
+     * @brief Sets the sink which receives all log messages.
+     */
+    void
+    setLogSink(std::shared_ptr<ILogSink> sink);
+
+    /**
+     * @brief Sets the lowest level of the messages which are written at runtime.
+     *
+     * Messages below `KMEANS_LOG_LEVEL` are never written since they are removed at compile time.
+     */
+    void
+    setLogLevel(LogLevel level);
+
+    /**
+     * @brief Whether messages of the given level are written.
+     */
+    bool
+    isLogEnabled(LogLevel level);
+
+    /**
+     * @brief Formats a message like printf and writes it to the sink. Prefer the `KMEANS_LOG_*` macros
+     * which are removed at compile time below `KMEANS_LOG_LEVEL`.
+     */
+    void
+    log(LogLevel level, const char *format, ...)
+#if defined(__GNUC__)
+        __attribute__((format(printf, 2, 3)))
+#endif
+        ;
+
+    /**
+     * @brief Formats a value with its stream output operator, e.g., to log a matrix with "%s".
+     */
+    template <typename T>
+    std::string
+    toString(const T &value)
+    {
+        std::ostringstream stream;
+        stream << value;
+        return stream.str();
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace utils
+{
+    /**
+     * @brief Resolves the number of threads to use. Zero means one thread per hardware core.
+     */
+    size_t
+    resolveNumberOfThreads(size_t numThreads);
+
+    /**
+     * @brief Splits the range [begin, end) into `numPartitions` contiguous partitions and processes
+     * them on up to `numThreads` threads.
+     *
+     * The partition boundaries only depend on the range and `numPartitions`, so per-partition
+     * results reduced in partition order are the same regardless of the number of threads.
+     * The work is shared between the calling thread and the threads of a pool which is kept for the
+     * lifetime of the process. If `body` throws, no further partitions are started and the first
+     * exception is rethrown on the calling thread once all started partitions have finished.
+     *
+     * @param begin The first index in the range.
+     * @param end One past the last index in the range.
+     * @param numPartitions The number of partitions to split the range into.
+     * @param numThreads The maximum number of threads to use.
+     * @param body Called as body(partitionIndex, partitionBegin, partitionEnd) once for each partition.
+     */
+    void
+    parallelForPartitions(size_t begin, size_t end, size_t numPartitions, size_t numThreads,
+                          const std::function<void(size_t, size_t, size_t)> &body);
+
+    /**
+     * @brief Processes the range [begin, end) in contiguous chunks on up to `numThreads` threads.
+     * @param begin The first index in the range.
+     * @param end One past the last index in the range.
+     * @param numThreads The maximum number of threads to use.
+     * @param body Called as body(chunkBegin, chunkEnd) for disjoint chunks which cover the range.
+     * @throws The first exception thrown by `body`, after all started chunks have finished.
+     */
+    void
+    parallelFor(size_t begin, size_t end, size_t numThreads, const std::function<void(size_t, size_t)> &body);
+}
@@ -4,6 +4,8 @@
 #include <iostream>
 #include <memory>
 #include <random>
+#include <sstream>
+#include <string>
 #include <vector>
 
 #include <blaze/Math.h>
@@ -11,6 +13,11 @@
 
 namespace utils
 {
+    /**
+     * The seed used by `Random` unless another seed is given.
+     */
+    const int DefaultRandomSeed = 42;
+
     class RandomIndexer
     {
     public:
@@ -22,6 +29,66 @@ namespace utils
         std::uniform_int_distribution<size_t> sampler;
     };
 
+    /**
+     * @brief Samples indices with probability proportional to their weights.
+     *
+     * The weights are stored in a Fenwick (binary indexed) tree so both changing the weight of an
+     * index and drawing an index take O(log n) time. This makes it cheap to sample repeatedly from
+     * weights where only a few entries change between draws, e.g., D^2 sampling.
+     */
+    class WeightedSampler
+    {
+    public:
+        /**
+         * @brief Creates a sampler over `n` indices whose weights are all zero.
+         */
+        WeightedSampler(size_t n);
+
+        /**
+         * @brief Creates a sampler from the given non-negative weights in O(n) time.
+         */
+        WeightedSampler(const blaze::DynamicVector<double> &weights);
+
+        /**
+         * @brief Sets the weight of an index.
+         * @param index The index to update.
+         * @param weight The new non-negative weight.
+         */
+        void
+        update(size_t index, double weight);
+
+        /**
+         * @brief Replaces all the weights in O(n) time.
+         */
+        void
+        rebuild(const blaze::DynamicVector<double> &weights);
+
+        /**
+         * @brief Returns the index i such that the sum of the weights before i is at most `target` and
+         * the sum of the weights up to and including i is larger than `target`.
+         * @param target A value in the range [0, getTotalWeight()).
+         */
+        size_t
+        find(double target) const;
+
+        double
+        getWeight(size_t index) const;
+
+        double
+        getTotalWeight() const;
+
+        size_t
+        size() const;
+
+    private:
+        std::vector<double> weights;
+
+        /**
+         * Fenwick tree where node i (1-based) holds the sum of the weights in (i - lowbit(i), i].
+         */
+        std::vector<double> tree;
+    };
+
     class Random
     {
     public:
@@ -51,6 +118,12 @@ namespace utils
         size_t
         choice(blaze::DynamicVector<double> weights);
 
+        /**
+         * @brief Randomly select an index with probability proportional to the weights in the sampler.
+         */
+        size_t
+        choice(const WeightedSampler &sampler);
+
         /**
          * @brief Select a number of elements from vector uniformly at random.
          * @param elements A collection of elements to sample from.
@@ -88,7 +161,28 @@ namespace utils
          * @brief Initialises random class.
          * @param fixedSeed The seed for random number generators. Use a value other than -1 to make the randomized algorithms deterministic. Choose -1 to generate a random seed.
          */
-        Random(int fixedSeed = 42);
+        Random(int fixedSeed = DefaultRandomSeed);
+
+        /**
+         * @brief Initialises random class with one of several independent streams derived from the same seed.
+         *
+         * Stream 0 is the same as `Random(fixedSeed)`, so a single stream reproduces the results of a single run.
+         * @param fixedSeed The seed for random number generators. Choose -1 to generate a random seed.
+         * @param streamIndex The index of the stream, e.g., the index of a trial among several restarts.
+         */
+        Random(int fixedSeed, size_t streamIndex);
+
+        /**
+         * @brief Returns the state of the random engine so a run can be resumed from a checkpoint.
+         */
+        std::string
+        getState() const;
+
+        /**
+         * @brief Restores the state of the random engine returned by `getState`.
+         */
+        void
+        setState(const std::string &state);
 
     private:
         std::mt19937 randomEngine;
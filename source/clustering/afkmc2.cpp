@@ -0,0 +1,82 @@
+#include <clustering/afkmc2.hpp>
+
+using namespace clustering;
+
+template <typename T>
+AFKMC2Initialiser<T>::AFKMC2Initialiser(const blaze::DynamicMatrix<T> &matrix, size_t numThreads, size_t chainLength) : data(matrix), NumThreads(numThreads), ChainLength(chainLength)
+{
+}
+
+template <typename T>
+std::vector<size_t>
+AFKMC2Initialiser<T>::pickCenters(size_t k, utils::Random &random)
+{
+    const size_t n = data.rows();
+
+    // Pick the first centroid uniformly at random.
+    auto randomPointGenerator = random.getIndexer(n);
+    std::vector<size_t> centers{randomPointGenerator.next()};
+    centers.reserve(k);
+
+    // The only pass over the data: q(x) = 1/2 * d(x, c1)^2 / sum d(x', c1)^2 + 1/(2N)
+    blaze::DynamicVector<double> proposal(n);
+    const auto firstCenter = blaze::row(data, centers[0]);
+    utils::parallelFor(0, n, NumThreads, [&](size_t beginPoint, size_t endPoint)
+                       {
+                           for (size_t p = beginPoint; p < endPoint; p++)
+                           {
+                               proposal[p] = static_cast<double>(blaze::sqrNorm(blaze::row(data, p) - firstCenter));
+                           }
+                       });
+
+    const double totalDistance = blaze::sum(proposal);
+    for (size_t p = 0; p < n; p++)
+    {
+        const double distanceTerm = totalDistance > 0.0 ? proposal[p] / totalDistance : 1.0 / static_cast<double>(n);
+        proposal[p] = 0.5 * distanceTerm + 0.5 / static_cast<double>(n);
+    }
+
+    utils::WeightedSampler proposalSampler(proposal);
+
+    for (size_t c = 1; c < k; c++)
+    {
+        // Start the chain from a point drawn from the proposal distribution.
+        size_t x = random.choice(proposalSampler);
+        double xDistance = calcMinSquaredDistance(x, centers);
+
+        for (size_t j = 1; j < ChainLength; j++)
+        {
+            const size_t y = random.choice(proposalSampler);
+            const double yDistance = calcMinSquaredDistance(y, centers);
+
+            // Accept y with probability min(1, (d(y, C)^2 * q(x)) / (d(x, C)^2 * q(y))).
+            const double acceptanceNumerator = yDistance * proposal[x];
+            const double acceptanceDenominator = xDistance * proposal[y];
+            if (acceptanceDenominator == 0.0 || acceptanceNumerator > random.getDouble() * acceptanceDenominator)
+            {
+                x = y;
+                xDistance = yDistance;
+            }
+        }
+
+        KMEANS_LOG_DEBUG("Center index for %ld => %ld", c, x);
+        centers.push_back(x);
+    }
+
+    return centers;
+}
+
+template <typename T>
+double
+AFKMC2Initialiser<T>::calcMinSquaredDistance(size_t pointIndex, const std::vector<size_t> &centers) const
+{
+    double smallestDistance = std::numeric_limits<double>::max();
+    for (auto &&c : centers)
+    {
+        smallestDistance = std::min(smallestDistance, static_cast<double>(blaze::sqrNorm(blaze::row(data, pointIndex) - blaze::row(data, c))));
+    }
+    return smallestDistance;
+}
+
+template class clustering::AFKMC2Initialiser<float>;
+template class clustering::AFKMC2Initialiser<double>;
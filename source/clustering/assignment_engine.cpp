@@ -0,0 +1,78 @@
+#include <clustering/assignment_engine.hpp>
+#include <clustering/blocked_assignment.hpp>
+#include <clustering/bounded_assignment.hpp>
+#include <clustering/fixed_dimension_assignment.hpp>
+#include <clustering/kd_tree_assignment.hpp>
+#include <clustering/simd_assignment.hpp>
+#include <clustering/yinyang_assignment.hpp>
+#include <utils/parallel.hpp>
+
+using namespace clustering;
+
+template <typename T>
+StandardAssignmentEngine<T>::StandardAssignmentEngine(size_t numThreads, std::shared_ptr<const blaze::DynamicVector<T>> norms) : NumThreads(numThreads), dataSquaredNorms(norms)
+{
+}
+
+template <typename T>
+void
+StandardAssignmentEngine<T>::assign(const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<T> &centers, ClusterAssignmentList &assignments)
+{
+    if (isSimdAssignmentSupported<T>(data.columns(), centers.rows()))
+    {
+        // The vectorised kernels compute the distances directly, so no norms are needed.
+        utils::parallelFor(0, data.rows(), NumThreads, [&](size_t beginPoint, size_t endPoint)
+                           { assignClosestCentersSimd(data, centers, assignments, beginPoint, endPoint); });
+        return;
+    }
+
+    if (isFixedDimensionSupported(data.columns()))
+    {
+        // Low dimensional data is assigned with unrolled kernels instead of a matrix multiplication.
+        utils::parallelFor(0, data.rows(), NumThreads, [&](size_t beginPoint, size_t endPoint)
+                           { assignClosestCentersFixedDimension(data, centers, assignments, beginPoint, endPoint); });
+        return;
+    }
+
+    if (dataSquaredNorms == nullptr || dataSquaredNorms->size() != data.rows())
+    {
+        dataSquaredNorms = std::make_shared<const blaze::DynamicVector<T>>(calcSquaredRowNorms(data));
+    }
+
+    // Each thread computes its own tiles of points.
+    utils::parallelFor(0, data.rows(), NumThreads, [&](size_t beginPoint, size_t endPoint)
+                       { assignClosestCentersBlocked(data, *dataSquaredNorms, centers, assignments, beginPoint, endPoint); });
+}
+
+template <typename T>
+void
+StandardAssignmentEngine<T>::finalise(const blaze::DynamicMatrix<T> &/*data*/, ClusterAssignmentList &/*assignments*/)
+{
+    // Costs are always exact.
+}
+
+template <typename T>
+std::shared_ptr<IAssignmentEngine<T>>
+clustering::createAssignmentEngine(AssignmentMode mode, size_t numOfPoints, size_t numOfClusters, size_t numThreads, std::shared_ptr<const blaze::DynamicVector<T>> dataSquaredNorms)
+{
+    switch (mode)
+    {
+    case AssignmentMode::Elkan:
+        return std::make_shared<ElkanAssignmentEngine<T>>(numOfPoints, numOfClusters, numThreads);
+    case AssignmentMode::Hamerly:
+        return std::make_shared<HamerlyAssignmentEngine<T>>(numOfPoints, numOfClusters, numThreads);
+    case AssignmentMode::Yinyang:
+        return std::make_shared<YinyangAssignmentEngine<T>>(numOfPoints, numOfClusters, numThreads);
+    case AssignmentMode::KdTree:
+        return std::make_shared<KdTreeAssignmentEngine<T>>(numOfClusters, numThreads);
+    case AssignmentMode::Standard:
+    default:
+        return std::make_shared<StandardAssignmentEngine<T>>(numThreads, dataSquaredNorms);
+    }
+}
+
+template class clustering::StandardAssignmentEngine<float>;
+template class clustering::StandardAssignmentEngine<double>;
+
+template std::shared_ptr<IAssignmentEngine<float>> clustering::createAssignmentEngine<float>(AssignmentMode, size_t, size_t, size_t, std::shared_ptr<const blaze::DynamicVector<float>>);
+template std::shared_ptr<IAssignmentEngine<double>> clustering::createAssignmentEngine<double>(AssignmentMode, size_t, size_t, size_t, std::shared_ptr<const blaze::DynamicVector<double>>);
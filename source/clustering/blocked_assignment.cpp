@@ -0,0 +1,74 @@
+#include <clustering/blocked_assignment.hpp>
+
+using namespace clustering;
+
+template <typename T>
+blaze::DynamicVector<T>
+clustering::calcSquaredRowNorms(const blaze::DynamicMatrix<T> &matrix)
+{
+    blaze::DynamicVector<T> norms(matrix.rows());
+    for (size_t i = 0; i < matrix.rows(); i++)
+    {
+        norms[i] = blaze::sqrNorm(blaze::row(matrix, i));
+    }
+    return norms;
+}
+
+template <typename T>
+void
+clustering::assignClosestCentersBlocked(const blaze::DynamicMatrix<T> &data, const blaze::DynamicVector<T> &dataSquaredNorms,
+                                        const blaze::DynamicMatrix<T> &centers, ClusterAssignmentList &assignments,
+                                        size_t beginPoint, size_t endPoint)
+{
+    const size_t k = centers.rows();
+    const size_t d = data.columns();
+    const auto centerSquaredNorms = calcSquaredRowNorms(centers);
+
+    blaze::DynamicMatrix<T> dotProducts(AssignmentTilePoints, AssignmentTileCenters);
+    blaze::DynamicVector<T> bestDistances(AssignmentTilePoints);
+    blaze::DynamicVector<size_t> bestClusters(AssignmentTilePoints);
+
+    for (size_t p0 = beginPoint; p0 < endPoint; p0 += AssignmentTilePoints)
+    {
+        const size_t tilePoints = std::min(AssignmentTilePoints, endPoint - p0);
+        const auto pointsTile = blaze::submatrix(data, p0, 0, tilePoints, d);
+
+        bestDistances = std::numeric_limits<T>::max();
+        bestClusters = 0;
+
+        for (size_t c0 = 0; c0 < k; c0 += AssignmentTileCenters)
+        {
+            const size_t tileCenters = std::min(AssignmentTileCenters, k - c0);
+
+            // x·c for all pairs in the tile.
+            dotProducts = pointsTile * blaze::trans(blaze::submatrix(centers, c0, 0, tileCenters, d));
+
+            for (size_t i = 0; i < tilePoints; i++)
+            {
+                const T pointNorm = dataSquaredNorms[p0 + i];
+
+                for (size_t j = 0; j < tileCenters; j++)
+                {
+                    const T distance = pointNorm - T(2) * dotProducts(i, j) + centerSquaredNorms[c0 + j];
+                    if (distance < bestDistances[i])
+                    {
+                        bestDistances[i] = distance;
+                        bestClusters[i] = c0 + j;
+                    }
+                }
+            }
+        }
+
+        for (size_t i = 0; i < tilePoints; i++)
+        {
+            // Cancellation can make the squared distance slightly negative.
+            assignments.assign(p0 + i, bestClusters[i], std::sqrt(std::max(0.0, static_cast<double>(bestDistances[i]))));
+        }
+    }
+}
+
+template blaze::DynamicVector<float> clustering::calcSquaredRowNorms(const blaze::DynamicMatrix<float> &);
+template blaze::DynamicVector<double> clustering::calcSquaredRowNorms(const blaze::DynamicMatrix<double> &);
+
+template void clustering::assignClosestCentersBlocked(const blaze::DynamicMatrix<float> &, const blaze::DynamicVector<float> &, const blaze::DynamicMatrix<float> &, ClusterAssignmentList &, size_t, size_t);
+template void clustering::assignClosestCentersBlocked(const blaze::DynamicMatrix<double> &, const blaze::DynamicVector<double> &, const blaze::DynamicMatrix<double> &, ClusterAssignmentList &, size_t, size_t);
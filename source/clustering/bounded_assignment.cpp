@@ -0,0 +1,309 @@
+#include <clustering/bounded_assignment.hpp>
+
+using namespace clustering;
+
+template <typename T>
+BoundedAssignmentEngine<T>::BoundedAssignmentEngine(size_t n, size_t k, size_t numThreads) : NumOfPoints(n), NumOfClusters(k), NumThreads(numThreads), isInitialised(false),
+                                                                                             centerShifts(k), upperBounds(n), upperBoundIsTight(n)
+{
+}
+
+template <typename T>
+void
+BoundedAssignmentEngine<T>::assign(const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<T> &centers, ClusterAssignmentList &assignments)
+{
+    if (isInitialised)
+    {
+        // Compute how far each center moved since the previous assignment step: δ(c)
+        for (size_t c = 0; c < NumOfClusters; c++)
+        {
+            centerShifts[c] = static_cast<double>(blaze::norm(blaze::row(centers, c) - blaze::row(previousCenters, c)));
+        }
+    }
+
+    prepare(centers);
+
+    utils::parallelFor(0, NumOfPoints, NumThreads, [&](size_t beginPoint, size_t endPoint)
+                       {
+                           if (isInitialised)
+                           {
+                               updateAssignments(data, centers, assignments, beginPoint, endPoint);
+                           }
+                           else
+                           {
+                               initialiseBounds(data, centers, assignments, beginPoint, endPoint);
+                           }
+                       });
+
+    isInitialised = true;
+    previousCenters = centers;
+}
+
+template <typename T>
+void
+BoundedAssignmentEngine<T>::finalise(const blaze::DynamicMatrix<T> &data, ClusterAssignmentList &assignments)
+{
+    utils::parallelFor(0, NumOfPoints, NumThreads, [&](size_t beginPoint, size_t endPoint)
+                       {
+                           for (size_t p = beginPoint; p < endPoint; p++)
+                           {
+                               if (upperBoundIsTight[p])
+                               {
+                                   continue;
+                               }
+
+                               const size_t c = assignments.getCluster(p);
+                               upperBounds[p] = distance(data, p, previousCenters, c);
+                               upperBoundIsTight[p] = true;
+                               assignments.assign(p, c, upperBounds[p]);
+                           }
+                       });
+}
+
+template <typename T>
+void
+BoundedAssignmentEngine<T>::computeCenterDistances(const blaze::DynamicMatrix<T> &centers)
+{
+    centerDistances.resize(NumOfClusters, NumOfClusters, false);
+    halfClosestCenterDistances.resize(NumOfClusters, false);
+    halfClosestCenterDistances = std::numeric_limits<double>::max();
+
+    for (size_t c1 = 0; c1 < NumOfClusters; c1++)
+    {
+        centerDistances(c1, c1) = 0.0;
+
+        for (size_t c2 = c1 + 1; c2 < NumOfClusters; c2++)
+        {
+            const double d = static_cast<double>(blaze::norm(blaze::row(centers, c1) - blaze::row(centers, c2)));
+            centerDistances(c1, c2) = d;
+            centerDistances(c2, c1) = d;
+
+            // s(c) = 1/2 * min_{c' != c} d(c, c')
+            halfClosestCenterDistances[c1] = std::min(halfClosestCenterDistances[c1], 0.5 * d);
+            halfClosestCenterDistances[c2] = std::min(halfClosestCenterDistances[c2], 0.5 * d);
+        }
+    }
+}
+
+template <typename T>
+ElkanAssignmentEngine<T>::ElkanAssignmentEngine(size_t n, size_t k, size_t numThreads) : BoundedAssignmentEngine<T>(n, k, numThreads), lowerBounds(n, k)
+{
+}
+
+template <typename T>
+void
+ElkanAssignmentEngine<T>::prepare(const blaze::DynamicMatrix<T> &centers)
+{
+    if (isInitialised)
+    {
+        computeCenterDistances(centers);
+    }
+}
+
+template <typename T>
+void
+ElkanAssignmentEngine<T>::initialiseBounds(const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<T> &centers, ClusterAssignmentList &assignments, size_t beginPoint, size_t endPoint)
+{
+    for (size_t p = beginPoint; p < endPoint; p++)
+    {
+        double bestDistance = std::numeric_limits<double>::max();
+        size_t bestCluster = 0;
+
+        for (size_t c = 0; c < NumOfClusters; c++)
+        {
+            const double d = distance(data, p, centers, c);
+            lowerBounds(p, c) = d;
+
+            if (d < bestDistance)
+            {
+                bestDistance = d;
+                bestCluster = c;
+            }
+        }
+
+        upperBounds[p] = bestDistance;
+        upperBoundIsTight[p] = true;
+        assignments.assign(p, bestCluster, bestDistance);
+    }
+}
+
+template <typename T>
+void
+ElkanAssignmentEngine<T>::updateAssignments(const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<T> &centers, ClusterAssignmentList &assignments, size_t beginPoint, size_t endPoint)
+{
+    for (size_t p = beginPoint; p < endPoint; p++)
+    {
+        size_t a = assignments.getCluster(p);
+
+        // Loosen the bounds by the distance the centers moved.
+        upperBounds[p] += centerShifts[a];
+        if (centerShifts[a] > 0.0)
+        {
+            upperBoundIsTight[p] = false;
+        }
+
+        for (size_t c = 0; c < NumOfClusters; c++)
+        {
+            lowerBounds(p, c) = std::max(0.0, lowerBounds(p, c) - centerShifts[c]);
+        }
+
+        // If u(p) <= s(a) then no other center can be closer than the assigned one.
+        if (upperBounds[p] <= halfClosestCenterDistances[a])
+        {
+            assignments.assign(p, a, upperBounds[p]);
+            continue;
+        }
+
+        for (size_t c = 0; c < NumOfClusters; c++)
+        {
+            // Center `c` can only be closer if u(p) > l(p, c) and u(p) > d(a, c)/2.
+            if (c == a || upperBounds[p] <= lowerBounds(p, c) || upperBounds[p] <= 0.5 * centerDistances(a, c))
+            {
+                continue;
+            }
+
+            if (!upperBoundIsTight[p])
+            {
+                upperBounds[p] = distance(data, p, centers, a);
+                lowerBounds(p, a) = upperBounds[p];
+                upperBoundIsTight[p] = true;
+
+                if (upperBounds[p] <= lowerBounds(p, c) || upperBounds[p] <= 0.5 * centerDistances(a, c))
+                {
+                    continue;
+                }
+            }
+
+            const double d = distance(data, p, centers, c);
+            lowerBounds(p, c) = d;
+
+            if (d < upperBounds[p])
+            {
+                a = c;
+                upperBounds[p] = d;
+            }
+        }
+
+        assignments.assign(p, a, upperBounds[p]);
+    }
+}
+
+template <typename T>
+HamerlyAssignmentEngine<T>::HamerlyAssignmentEngine(size_t n, size_t k, size_t numThreads) : BoundedAssignmentEngine<T>(n, k, numThreads), lowerBounds(n),
+                                                                                               largestShiftCluster(0), largestShift(0.0), secondLargestShift(0.0)
+{
+}
+
+template <typename T>
+void
+HamerlyAssignmentEngine<T>::assignToClosestCenter(const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<T> &centers, ClusterAssignmentList &assignments, size_t p)
+{
+    double bestDistance = std::numeric_limits<double>::max();
+    double secondBestDistance = std::numeric_limits<double>::max();
+    size_t bestCluster = 0;
+
+    for (size_t c = 0; c < NumOfClusters; c++)
+    {
+        const double d = distance(data, p, centers, c);
+
+        if (d < bestDistance)
+        {
+            secondBestDistance = bestDistance;
+            bestDistance = d;
+            bestCluster = c;
+        }
+        else if (d < secondBestDistance)
+        {
+            secondBestDistance = d;
+        }
+    }
+
+    upperBounds[p] = bestDistance;
+    upperBoundIsTight[p] = true;
+    lowerBounds[p] = secondBestDistance;
+    assignments.assign(p, bestCluster, bestDistance);
+}
+
+template <typename T>
+void
+HamerlyAssignmentEngine<T>::initialiseBounds(const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<T> &centers, ClusterAssignmentList &assignments, size_t beginPoint, size_t endPoint)
+{
+    for (size_t p = beginPoint; p < endPoint; p++)
+    {
+        assignToClosestCenter(data, centers, assignments, p);
+    }
+}
+
+template <typename T>
+void
+HamerlyAssignmentEngine<T>::prepare(const blaze::DynamicMatrix<T> &centers)
+{
+    if (!isInitialised)
+    {
+        return;
+    }
+
+    computeCenterDistances(centers);
+
+    // The lower bound of a point is loosened by the largest shift of any center other than
+    // its own, so track the two centers that moved the most.
+    largestShiftCluster = 0;
+    largestShift = 0.0;
+    secondLargestShift = 0.0;
+    for (size_t c = 0; c < NumOfClusters; c++)
+    {
+        if (centerShifts[c] > largestShift)
+        {
+            secondLargestShift = largestShift;
+            largestShift = centerShifts[c];
+            largestShiftCluster = c;
+        }
+        else if (centerShifts[c] > secondLargestShift)
+        {
+            secondLargestShift = centerShifts[c];
+        }
+    }
+}
+
+template <typename T>
+void
+HamerlyAssignmentEngine<T>::updateAssignments(const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<T> &centers, ClusterAssignmentList &assignments, size_t beginPoint, size_t endPoint)
+{
+    for (size_t p = beginPoint; p < endPoint; p++)
+    {
+        const size_t a = assignments.getCluster(p);
+
+        upperBounds[p] += centerShifts[a];
+        if (centerShifts[a] > 0.0)
+        {
+            upperBoundIsTight[p] = false;
+        }
+        lowerBounds[p] -= (a == largestShiftCluster) ? secondLargestShift : largestShift;
+
+        // m = max(s(a), l(p))
+        const double bound = std::max(halfClosestCenterDistances[a], lowerBounds[p]);
+        if (upperBounds[p] <= bound)
+        {
+            assignments.assign(p, a, upperBounds[p]);
+            continue;
+        }
+
+        // Tighten the upper bound and test again before scanning all centers.
+        upperBounds[p] = distance(data, p, centers, a);
+        upperBoundIsTight[p] = true;
+        if (upperBounds[p] <= bound)
+        {
+            assignments.assign(p, a, upperBounds[p]);
+            continue;
+        }
+
+        assignToClosestCenter(data, centers, assignments, p);
+    }
+}
+
+template class clustering::BoundedAssignmentEngine<float>;
+template class clustering::BoundedAssignmentEngine<double>;
+template class clustering::ElkanAssignmentEngine<float>;
+template class clustering::ElkanAssignmentEngine<double>;
+template class clustering::HamerlyAssignmentEngine<float>;
+template class clustering::HamerlyAssignmentEngine<double>;
@@ -1,4 +1,10 @@
 #include <clustering/cluster_assignment_list.hpp>
+#include <clustering/assignment_engine.hpp>
+#include <clustering/blocked_assignment.hpp>
+#include <clustering/distance_cache.hpp>
+#include <clustering/fixed_dimension_assignment.hpp>
+#include <clustering/simd_assignment.hpp>
+#include <clustering/sparse_assignment.hpp>
 
 using namespace clustering;
 
@@ -7,7 +13,7 @@ ClusterAssignmentList::ClusterAssignmentList(size_t n, size_t k) : numOfPoints(n
 }
 
 ClusterAssignmentList::ClusterAssignmentList(const ClusterAssignmentList& other) : 
-    numOfPoints(other.numOfPoints), numOfClusters(other.numOfClusters), clusters(other.clusters), distances(other.distances)
+    numOfPoints(other.numOfPoints), numOfClusters(other.numOfClusters), clusters(other.clusters), distances(other.distances), weights(other.weights)
 {
 }
 
@@ -18,34 +24,72 @@ void ClusterAssignmentList::assign(size_t pointIndex, size_t clusterIndex, doubl
     distances[pointIndex] = distance;
 }
 
+template <typename T>
 void
-ClusterAssignmentList::assignAll(const blaze::DynamicMatrix<double> &dataPoints, const blaze::DynamicMatrix<double> &centers)
+ClusterAssignmentList::assignAll(const blaze::DynamicMatrix<T> &dataPoints, const blaze::DynamicMatrix<T> &centers)
 {
-    auto n = this->numOfPoints;
-    auto k = this->numOfClusters;
-
     // For each data point, assign the centroid that is closest to it.
-    for (size_t p = 0; p < n; p++)
+    if (isSimdAssignmentSupported<T>(dataPoints.columns(), centers.rows()))
     {
-      double bestDistance = std::numeric_limits<double>::max();
-      size_t bestCluster = 0;
+        assignClosestCentersSimd(dataPoints, centers, *this, 0, this->numOfPoints);
+        return;
+    }
 
-      // Loop through all the clusters.
-      for (size_t c = 0; c < k; c++)
-      {
-        // Compute the L2 norm between point p and centroid c.
-        const double distance = blaze::norm(blaze::row(dataPoints, p) - blaze::row(centers, c));
+    if (assignClosestCentersFixedDimension(dataPoints, centers, *this, 0, this->numOfPoints))
+    {
+        return;
+    }
 
-        // Decide if current distance is better.
-        if (distance < bestDistance)
+    auto dataSquaredNorms = calcSquaredRowNorms(dataPoints);
+    assignClosestCentersBlocked(dataPoints, dataSquaredNorms, centers, *this, 0, this->numOfPoints);
+}
+
+template <typename T>
+void
+ClusterAssignmentList::assignAll(const blaze::CompressedMatrix<T> &dataPoints, const blaze::DynamicMatrix<T> &centers)
+{
+    auto dataSquaredNorms = calcSquaredRowNorms(dataPoints);
+    blaze::DynamicMatrix<T> transposedCenters;
+    blaze::DynamicVector<T> centerSquaredNorms;
+    prepareSparseAssignmentCenters(centers, transposedCenters, centerSquaredNorms);
+    assignClosestCentersSparse(dataPoints, dataSquaredNorms, transposedCenters, centerSquaredNorms, *this, 0, this->numOfPoints);
+}
+
+template <typename T>
+void
+ClusterAssignmentList::assignAll(const blaze::DynamicMatrix<T> &dataPoints, const blaze::DynamicMatrix<T> &centers, IAssignmentEngine<T> &engine)
+{
+    engine.assign(dataPoints, centers, *this);
+    engine.finalise(dataPoints, *this);
+}
+
+template <typename T>
+void
+ClusterAssignmentList::assignAll(PairwiseDistanceCache<T> &distanceCache, const std::vector<size_t> &centerPoints)
+{
+    std::vector<CachedDistanceRow<T>> centerDistances;
+    centerDistances.reserve(centerPoints.size());
+    for (auto &&centerPoint : centerPoints)
+    {
+        centerDistances.push_back(distanceCache.getRow(centerPoint));
+    }
+
+    for (size_t p = 0; p < this->numOfPoints; p++)
+    {
+        T bestDistance = std::numeric_limits<T>::max();
+        size_t bestCluster = 0;
+
+        for (size_t c = 0; c < centerDistances.size(); c++)
         {
-          bestDistance = distance;
-          bestCluster = c;
+            const T distance = centerDistances[c][p];
+            if (distance < bestDistance)
+            {
+                bestDistance = distance;
+                bestCluster = c;
+            }
         }
-      }
 
-      // Assign cluster to the point p.
-      this->assign(p, bestCluster, bestDistance);
+        this->assign(p, bestCluster, std::sqrt(static_cast<double>(bestDistance)));
     }
 }
 
@@ -89,9 +133,37 @@ ClusterAssignmentList::countPointsInCluster(size_t clusterIndex) const
     return count;
 }
 
+void
+ClusterAssignmentList::setPointWeights(const blaze::DynamicVector<double> &pointWeights)
+{
+    if (pointWeights.size() != 0 && pointWeights.size() != this->numOfPoints)
+    {
+        throw std::invalid_argument("The number of weights must be the number of points.");
+    }
+
+    this->weights = pointWeights;
+}
+
+bool
+ClusterAssignmentList::hasPointWeights() const
+{
+    return this->weights.size() != 0;
+}
+
+double
+ClusterAssignmentList::getPointWeight(size_t pointIndex) const
+{
+    return this->hasPointWeights() ? this->weights[pointIndex] : 1.0;
+}
+
 double
 ClusterAssignmentList::getTotalCost() const
 {
+    if (this->hasPointWeights())
+    {
+        return blaze::dot(this->weights, this->distances);
+    }
+
     return blaze::sum(this->distances);
 }
 
@@ -109,18 +181,23 @@ ClusterAssignmentList::calcAverageClusterCosts() const
     auto results = std::make_shared<blaze::DynamicVector<double>>(this->numOfClusters);
     results->reset();
     
-    blaze::DynamicVector<double> counts(this->numOfClusters);
+    blaze::DynamicVector<double> counts(this->numOfClusters, 0.0);
 
     for (size_t p = 0; p < this->numOfPoints; p++) 
     {
         auto c = clusters[p];
-        (*results)[c] += distances[p];
-        counts[c] += 1;
+        const double weight = this->getPointWeight(p);
+        (*results)[c] += weight * distances[p];
+        counts[c] += weight;
     }
 
     for (size_t c = 0; c < this->numOfClusters; c++)
     {
-        (*results)[c] /= static_cast<double>(counts[c]);
+        // A cluster without weight has no points to average over, so its average cost stays zero.
+        if (counts[c] > 0.0)
+        {
+            (*results)[c] /= counts[c];
+        }
     }
 
     return results;
@@ -135,7 +212,7 @@ ClusterAssignmentList::calcClusterCosts() const
     for (size_t p = 0; p < this->numOfPoints; p++) 
     {
         auto c = clusters[p];
-        (*results)[c] += distances[p];
+        (*results)[c] += this->getPointWeight(p) * distances[p];
     }
 
     return results;
@@ -148,11 +225,65 @@ ClusterAssignmentList::operator=(const ClusterAssignmentList &other)
     this->numOfClusters = other.numOfClusters;
     this->clusters = other.clusters;
     this->distances = other.distances;
+    this->weights = other.weights;
     return *this;
 }
 
 blaze::DynamicVector<double>
 ClusterAssignmentList::getNormalizedCosts() const
 {
+    if (this->hasPointWeights())
+    {
+        const double totalCost = this->getTotalCost();
+        blaze::DynamicVector<double> normalizedCosts(this->numOfPoints);
+        for (size_t p = 0; p < this->numOfPoints; p++)
+        {
+            normalizedCosts[p] = weights[p] * distances[p] / totalCost;
+        }
+        return normalizedCosts;
+    }
+
     return distances / this->getTotalCost();
 }
+
+void
+ClusterAssignmentList::saveTo(utils::Checkpoint &checkpoint, const std::string &name) const
+{
+    checkpoint.setIndices(name + ".Clusters", std::vector<size_t>(clusters.begin(), clusters.end()));
+    checkpoint.setVector(name + ".Costs", distances);
+}
+
+void
+ClusterAssignmentList::loadFrom(const utils::Checkpoint &checkpoint, const std::string &name)
+{
+    auto savedClusters = checkpoint.getIndices(name + ".Clusters");
+    auto savedCosts = checkpoint.getVector(name + ".Costs");
+    if (savedClusters.size() != numOfPoints || savedCosts.size() != numOfPoints)
+    {
+        throw std::invalid_argument("The checkpoint has assignments for a different number of points.");
+    }
+
+    // Validate before changing anything, so the assignments are left as they were if the checkpoint is rejected.
+    for (size_t p = 0; p < numOfPoints; p++)
+    {
+        if (savedClusters[p] >= numOfClusters)
+        {
+            throw std::invalid_argument("The checkpoint assigns points to clusters which do not exist.");
+        }
+    }
+
+    for (size_t p = 0; p < numOfPoints; p++)
+    {
+        clusters[p] = savedClusters[p];
+    }
+    distances = savedCosts;
+}
+
+template void ClusterAssignmentList::assignAll(const blaze::DynamicMatrix<float> &, const blaze::DynamicMatrix<float> &);
+template void ClusterAssignmentList::assignAll(const blaze::DynamicMatrix<double> &, const blaze::DynamicMatrix<double> &);
+template void ClusterAssignmentList::assignAll(const blaze::CompressedMatrix<float> &, const blaze::DynamicMatrix<float> &);
+template void ClusterAssignmentList::assignAll(const blaze::CompressedMatrix<double> &, const blaze::DynamicMatrix<double> &);
+template void ClusterAssignmentList::assignAll(const blaze::DynamicMatrix<float> &, const blaze::DynamicMatrix<float> &, IAssignmentEngine<float> &);
+template void ClusterAssignmentList::assignAll(const blaze::DynamicMatrix<double> &, const blaze::DynamicMatrix<double> &, IAssignmentEngine<double> &);
+template void ClusterAssignmentList::assignAll(PairwiseDistanceCache<float> &, const std::vector<size_t> &);
+template void ClusterAssignmentList::assignAll(PairwiseDistanceCache<double> &, const std::vector<size_t> &);
@@ -0,0 +1,113 @@
+#include <clustering/distance_cache.hpp>
+
+using namespace clustering;
+
+template <typename T>
+CachedDistanceRow<T>::CachedDistanceRow(std::shared_ptr<const blaze::DynamicVector<T>> d) : distances(d)
+{
+}
+
+template <typename T>
+size_t
+CachedDistanceRow<T>::size() const
+{
+    return distances->size();
+}
+
+template <typename T>
+PairwiseDistanceCache<T>::PairwiseDistanceCache(const blaze::DynamicMatrix<T> &matrix, size_t memoryBudget) : data(matrix),
+                                                                                                              MaxCachedRows(std::max<size_t>(1, memoryBudget / (std::max<size_t>(1, matrix.rows()) * sizeof(T)))),
+                                                                                                              dataSquaredNorms(calcSquaredRowNorms(matrix))
+{
+}
+
+template <typename T>
+CachedDistanceRow<T>
+PairwiseDistanceCache<T>::getRow(size_t pointIndex)
+{
+    std::unique_lock<std::mutex> lock(cacheMutex);
+
+    auto cached = cachedRows.find(pointIndex);
+    if (cached != cachedRows.end())
+    {
+        // Move the row to the front of the LRU list. If it is still being computed, wait for it outside of the lock.
+        recentlyUsedRows.splice(recentlyUsedRows.begin(), recentlyUsedRows, cached->second.second);
+        auto pendingRow = cached->second.first;
+        lock.unlock();
+        return CachedDistanceRow<T>(pendingRow.get());
+    }
+
+    if (cachedRows.size() >= MaxCachedRows)
+    {
+        // Threads waiting for an evicted row keep its future alive.
+        cachedRows.erase(recentlyUsedRows.back());
+        recentlyUsedRows.pop_back();
+    }
+
+    std::promise<RowPointer> computedRow;
+    recentlyUsedRows.push_front(pointIndex);
+    cachedRows.emplace(pointIndex, std::make_pair(computedRow.get_future().share(), recentlyUsedRows.begin()));
+    lock.unlock();
+
+    RowPointer row;
+    try
+    {
+        row = computeRow(pointIndex);
+    }
+    catch (...)
+    {
+        // Hand the error to the waiting threads and let the next request compute the row again.
+        computedRow.set_exception(std::current_exception());
+        lock.lock();
+        cached = cachedRows.find(pointIndex);
+        if (cached != cachedRows.end())
+        {
+            recentlyUsedRows.erase(cached->second.second);
+            cachedRows.erase(cached);
+        }
+        throw;
+    }
+
+    computedRow.set_value(row);
+    return CachedDistanceRow<T>(row);
+}
+
+template <typename T>
+T
+PairwiseDistanceCache<T>::getSquaredDistance(size_t p1, size_t p2)
+{
+    return getRow(p1)[p2];
+}
+
+template <typename T>
+size_t
+PairwiseDistanceCache<T>::size() const
+{
+    return data.rows();
+}
+
+template <typename T>
+typename PairwiseDistanceCache<T>::RowPointer
+PairwiseDistanceCache<T>::computeRow(size_t pointIndex) const
+{
+    const size_t n = data.rows();
+
+    // x·y for the point and every point in the dataset.
+    auto distances = std::make_shared<blaze::DynamicVector<T>>(data * blaze::trans(blaze::row(data, pointIndex)));
+
+    const T pointNorm = dataSquaredNorms[pointIndex];
+    for (size_t j = 0; j < n; j++)
+    {
+        // Cancellation can make the squared distance slightly negative.
+        (*distances)[j] = std::max(T(0), pointNorm - T(2) * (*distances)[j] + dataSquaredNorms[j]);
+    }
+
+    (*distances)[pointIndex] = T(0);
+
+    return distances;
+}
+
+template class clustering::CachedDistanceRow<float>;
+template class clustering::CachedDistanceRow<double>;
+template class clustering::PairwiseDistanceCache<float>;
+template class clustering::PairwiseDistanceCache<double>;
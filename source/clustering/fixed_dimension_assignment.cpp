@@ -0,0 +1,39 @@
+#include <clustering/fixed_dimension_assignment.hpp>
+
+using namespace clustering;
+
+namespace
+{
+    template <typename T>
+    using FixedAssignmentKernel = void (*)(const blaze::DynamicMatrix<T> &, const blaze::DynamicMatrix<T> &, ClusterAssignmentList &, size_t, size_t);
+
+    /**
+     * Builds the table of kernels indexed by the number of dimensions minus one.
+     */
+    template <typename T, size_t... Indices>
+    constexpr std::array<FixedAssignmentKernel<T>, sizeof...(Indices)>
+    makeKernelTable(std::index_sequence<Indices...>)
+    {
+        return {{&assignClosestCentersFixed<Indices + 1, T>...}};
+    }
+}
+
+template <typename T>
+bool
+clustering::assignClosestCentersFixedDimension(const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<T> &centers,
+                                               ClusterAssignmentList &assignments, size_t beginPoint, size_t endPoint)
+{
+    static constexpr auto kernels = makeKernelTable<T>(std::make_index_sequence<MaxFixedDimension>());
+
+    const size_t d = data.columns();
+    if (!isFixedDimensionSupported(d))
+    {
+        return false;
+    }
+
+    kernels[d - 1](data, centers, assignments, beginPoint, endPoint);
+    return true;
+}
+
+template bool clustering::assignClosestCentersFixedDimension(const blaze::DynamicMatrix<float> &, const blaze::DynamicMatrix<float> &, ClusterAssignmentList &, size_t, size_t);
+template bool clustering::assignClosestCentersFixedDimension(const blaze::DynamicMatrix<double> &, const blaze::DynamicMatrix<double> &, ClusterAssignmentList &, size_t, size_t);
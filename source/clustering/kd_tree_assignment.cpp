@@ -0,0 +1,314 @@
+#include <clustering/kd_tree_assignment.hpp>
+
+using namespace clustering;
+
+template <typename T>
+KdTreeAssignmentEngine<T>::KdTreeAssignmentEngine(size_t k, size_t numThreads, size_t leafSize) : NumOfClusters(k), NumThreads(numThreads), LeafSize(std::max<size_t>(1, leafSize)), treeDepth(0)
+{
+}
+
+template <typename T>
+void
+KdTreeAssignmentEngine<T>::buildTree(const blaze::DynamicMatrix<T> &data)
+{
+    const size_t n = data.rows();
+    const size_t d = data.columns();
+
+    pointIndices.resize(n);
+    for (size_t p = 0; p < n; p++)
+    {
+        pointIndices[p] = p;
+    }
+
+    nodes.clear();
+    nodeLowerCorners.clear();
+    nodeUpperCorners.clear();
+    nodeSums.clear();
+    treeDepth = 0;
+    buildNode(data, 0, n, 0);
+
+    // Split the tree level by level until there are enough subtrees to keep the threads busy.
+    subtreeRoots = {0};
+    while (subtreeRoots.size() < KdTreeMaxSubtrees)
+    {
+        std::vector<size_t> nextRoots;
+        bool isSplit = false;
+        for (size_t node : subtreeRoots)
+        {
+            if (nodes[node].isLeaf)
+            {
+                nextRoots.push_back(node);
+                continue;
+            }
+
+            nextRoots.push_back(nodes[node].leftChild);
+            nextRoots.push_back(nodes[node].rightChild);
+            isSplit = true;
+        }
+
+        if (!isSplit || nextRoots.size() > KdTreeMaxSubtrees)
+        {
+            break;
+        }
+        subtreeRoots = nextRoots;
+    }
+
+    subtreeStates.resize(subtreeRoots.size());
+    for (auto &state : subtreeStates)
+    {
+        state.sums.resize(NumOfClusters, d);
+        state.counts.resize(NumOfClusters);
+    }
+
+    centroidSums.resize(NumOfClusters, d);
+    centroidCounts.resize(NumOfClusters);
+}
+
+template <typename T>
+size_t
+KdTreeAssignmentEngine<T>::buildNode(const blaze::DynamicMatrix<T> &data, size_t beginPoint, size_t endPoint, size_t depth)
+{
+    const size_t d = data.columns();
+    const size_t node = nodes.size();
+    treeDepth = std::max(treeDepth, depth);
+    nodes.push_back(Node{beginPoint, endPoint, 0, 0, true});
+
+    nodeLowerCorners.resize((node + 1) * d, std::numeric_limits<T>::max());
+    nodeUpperCorners.resize((node + 1) * d, std::numeric_limits<T>::lowest());
+    nodeSums.resize((node + 1) * d, 0.0);
+
+    for (size_t i = beginPoint; i < endPoint; i++)
+    {
+        const size_t p = pointIndices[i];
+        for (size_t j = 0; j < d; j++)
+        {
+            nodeLowerCorners[node * d + j] = std::min(nodeLowerCorners[node * d + j], data(p, j));
+            nodeUpperCorners[node * d + j] = std::max(nodeUpperCorners[node * d + j], data(p, j));
+        }
+    }
+
+    // Split along the widest side of the bounding box.
+    size_t splitDimension = 0;
+    T widestSide = T(0);
+    for (size_t j = 0; j < d; j++)
+    {
+        const T side = nodeUpperCorners[node * d + j] - nodeLowerCorners[node * d + j];
+        if (side > widestSide)
+        {
+            widestSide = side;
+            splitDimension = j;
+        }
+    }
+
+    // A leaf, or a node whose points all coincide.
+    if (endPoint - beginPoint <= LeafSize || widestSide == T(0))
+    {
+        for (size_t i = beginPoint; i < endPoint; i++)
+        {
+            const size_t p = pointIndices[i];
+            for (size_t j = 0; j < d; j++)
+            {
+                nodeSums[node * d + j] += static_cast<double>(data(p, j));
+            }
+        }
+        return node;
+    }
+
+    // Split at the median so the tree is balanced.
+    const size_t middlePoint = beginPoint + (endPoint - beginPoint) / 2;
+    std::nth_element(pointIndices.begin() + static_cast<std::ptrdiff_t>(beginPoint), pointIndices.begin() + static_cast<std::ptrdiff_t>(middlePoint), pointIndices.begin() + static_cast<std::ptrdiff_t>(endPoint),
+                     [&](size_t a, size_t b)
+                     { return data(a, splitDimension) < data(b, splitDimension); });
+
+    const size_t leftChild = buildNode(data, beginPoint, middlePoint, depth + 1);
+    const size_t rightChild = buildNode(data, middlePoint, endPoint, depth + 1);
+
+    // The children may have reallocated the nodes.
+    nodes[node].leftChild = leftChild;
+    nodes[node].rightChild = rightChild;
+    nodes[node].isLeaf = false;
+    for (size_t j = 0; j < d; j++)
+    {
+        nodeSums[node * d + j] = nodeSums[leftChild * d + j] + nodeSums[rightChild * d + j];
+    }
+
+    return node;
+}
+
+template <typename T>
+bool
+KdTreeAssignmentEngine<T>::isFarther(const blaze::DynamicMatrix<T> &centers, size_t candidate, size_t closest, size_t node) const
+{
+    const size_t d = centers.columns();
+
+    // The corner of the box furthest in the direction from `closest` to `candidate` is the point of
+    // the box which is the most likely to be closer to `candidate`.
+    double candidateDistance = 0.0;
+    double closestDistance = 0.0;
+    for (size_t j = 0; j < d; j++)
+    {
+        const double candidateValue = static_cast<double>(centers(candidate, j));
+        const double closestValue = static_cast<double>(centers(closest, j));
+        const double corner = static_cast<double>(candidateValue > closestValue ? nodeUpperCorners[node * d + j] : nodeLowerCorners[node * d + j]);
+
+        candidateDistance += (candidateValue - corner) * (candidateValue - corner);
+        closestDistance += (closestValue - corner) * (closestValue - corner);
+    }
+
+    return candidateDistance >= closestDistance;
+}
+
+template <typename T>
+void
+KdTreeAssignmentEngine<T>::filter(const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<T> &centers, ClusterAssignmentList &assignments,
+                                  size_t node, size_t depth, SubtreeState &state) const
+{
+    const size_t d = data.columns();
+    const Node &current = nodes[node];
+
+    const auto &candidates = state.candidates[depth];
+    auto &survivors = state.candidates[depth + 1];
+
+    // Find the candidate closest to the midpoint of the cell.
+    size_t closest = candidates[0];
+    double closestDistance = std::numeric_limits<double>::max();
+    for (size_t c : candidates)
+    {
+        double distance = 0.0;
+        for (size_t j = 0; j < d; j++)
+        {
+            const double midpoint = (static_cast<double>(nodeLowerCorners[node * d + j]) + static_cast<double>(nodeUpperCorners[node * d + j])) / 2.0;
+            const double diff = static_cast<double>(centers(c, j)) - midpoint;
+            distance += diff * diff;
+        }
+
+        if (distance < closestDistance)
+        {
+            closestDistance = distance;
+            closest = c;
+        }
+    }
+
+    survivors.clear();
+    for (size_t c : candidates)
+    {
+        if (c == closest || !isFarther(centers, c, closest, node))
+        {
+            survivors.push_back(c);
+        }
+    }
+
+    if (survivors.size() == 1)
+    {
+        // Every point in the cell is closest to the same center.
+        state.counts[closest] += current.endPoint - current.beginPoint;
+        for (size_t j = 0; j < d; j++)
+        {
+            state.sums(closest, j) += nodeSums[node * d + j];
+        }
+        for (size_t i = current.beginPoint; i < current.endPoint; i++)
+        {
+            assignments.assign(pointIndices[i], closest, 0.0);
+        }
+        return;
+    }
+
+    if (!current.isLeaf)
+    {
+        filter(data, centers, assignments, current.leftChild, depth + 1, state);
+        filter(data, centers, assignments, current.rightChild, depth + 1, state);
+        return;
+    }
+
+    for (size_t i = current.beginPoint; i < current.endPoint; i++)
+    {
+        const size_t p = pointIndices[i];
+
+        double bestDistance = std::numeric_limits<double>::max();
+        size_t bestCluster = survivors[0];
+        for (size_t c : survivors)
+        {
+            const double distance = static_cast<double>(blaze::sqrNorm(blaze::row(data, p) - blaze::row(centers, c)));
+            if (distance < bestDistance)
+            {
+                bestDistance = distance;
+                bestCluster = c;
+            }
+        }
+
+        state.counts[bestCluster] += 1;
+        for (size_t j = 0; j < d; j++)
+        {
+            state.sums(bestCluster, j) += static_cast<double>(data(p, j));
+        }
+        assignments.assign(p, bestCluster, std::sqrt(bestDistance));
+    }
+}
+
+template <typename T>
+void
+KdTreeAssignmentEngine<T>::assign(const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<T> &centers, ClusterAssignmentList &assignments)
+{
+    // The tree only depends on the data which does not change between calls.
+    if (pointIndices.size() != data.rows())
+    {
+        buildTree(data);
+    }
+
+    lastCenters = centers;
+
+    utils::parallelFor(0, subtreeRoots.size(), NumThreads, [&](size_t beginSubtree, size_t endSubtree)
+                       {
+                           for (size_t s = beginSubtree; s < endSubtree; s++)
+                           {
+                               auto &state = subtreeStates[s];
+                               state.sums = 0.0;
+                               state.counts = 0;
+
+                               // Every center is a candidate at the root of the subtree.
+                               state.candidates.resize(treeDepth + 2);
+                               state.candidates[0].resize(NumOfClusters);
+                               for (size_t c = 0; c < NumOfClusters; c++)
+                               {
+                                   state.candidates[0][c] = c;
+                               }
+
+                               filter(data, centers, assignments, subtreeRoots[s], 0, state);
+                           }
+                       });
+
+    centroidSums = 0.0;
+    centroidCounts = 0;
+    for (auto &state : subtreeStates)
+    {
+        centroidSums += state.sums;
+        centroidCounts += state.counts;
+    }
+}
+
+template <typename T>
+void
+KdTreeAssignmentEngine<T>::finalise(const blaze::DynamicMatrix<T> &data, ClusterAssignmentList &assignments)
+{
+    // Points assigned together with their cell do not have a cost yet.
+    utils::parallelFor(0, data.rows(), NumThreads, [&](size_t beginPoint, size_t endPoint)
+                       {
+                           for (size_t p = beginPoint; p < endPoint; p++)
+                           {
+                               const size_t c = assignments.getCluster(p);
+                               assignments.assign(p, c, static_cast<double>(blaze::norm(blaze::row(data, p) - blaze::row(lastCenters, c))));
+                           }
+                       });
+}
+
+template <typename T>
+bool
+KdTreeAssignmentEngine<T>::getCentroidSums(blaze::DynamicMatrix<double> &sums, blaze::DynamicVector<size_t> &counts) const
+{
+    sums = centroidSums;
+    counts = centroidCounts;
+    return true;
+}
+
+template class clustering::KdTreeAssignmentEngine<float>;
+template class clustering::KdTreeAssignmentEngine<double>;
@@ -2,47 +2,468 @@
 
 using namespace clustering;
 
-KMeans::KMeans(uint k, bool kpp, bool precomputeDistances, uint miter, double convDiff) : NumOfClusters(k), InitKMeansPlusPlus(kpp), PrecomputeDistances(precomputeDistances), MaxIterations(miter), ConvergenceDiff(convDiff)
+namespace
 {
+  /**
+   * Identifies checkpoints written by Lloyd's algorithm.
+   */
+  const char *const LloydsCheckpointName = "KMeans";
+
+  /**
+   * Describes the data and the configuration of a run. A checkpoint is only resumed by a run with the same description.
+   */
+  template <typename MatrixT>
+  utils::Checkpoint
+  describeLloydsRun(const MatrixT &data, size_t k, InitialisationMethod initMethod, size_t maxIterations, const blaze::DynamicVector<double> *pointWeights)
+  {
+    utils::Checkpoint description;
+    description.setText("Algorithm", LloydsCheckpointName);
+    description.setInteger("Points", data.rows());
+    description.setInteger("Dimensions", data.columns());
+    description.setInteger("DataFingerprint", utils::calcFingerprint(data));
+    description.setInteger("Clusters", k);
+    description.setInteger("InitMethod", static_cast<size_t>(initMethod));
+    description.setInteger("MaxIterations", maxIterations);
+    description.setInteger("Weighted", pointWeights != nullptr ? 1 : 0);
+    if (pointWeights != nullptr)
+    {
+      description.setInteger("WeightsFingerprint", utils::calcFingerprint(*pointWeights));
+    }
+    return description;
+  }
+
+  template <typename T>
+  std::shared_ptr<utils::Checkpoint>
+  makeLloydsCheckpoint(const utils::Checkpoint &runDescription, size_t iteration, bool isFinished, const blaze::DynamicMatrix<T> &centroids, const ClusterAssignmentList &assignments)
+  {
+    auto checkpoint = std::make_shared<utils::Checkpoint>();
+    checkpoint->setAll(runDescription);
+    checkpoint->setInteger("Iteration", iteration);
+    checkpoint->setInteger("Finished", isFinished ? 1 : 0);
+    checkpoint->setMatrix("Centroids", blaze::DynamicMatrix<double>(centroids));
+    assignments.saveTo(*checkpoint, "Assignments");
+    return checkpoint;
+  }
+
+  /**
+   * Checks that a checkpoint was written by a run with the given description and holds KxD centroids.
+   */
+  void
+  checkLloydsCheckpoint(const utils::Checkpoint &checkpoint, const utils::Checkpoint &runDescription, size_t k, size_t d)
+  {
+    if (!checkpoint.includes(runDescription))
+    {
+      throw std::invalid_argument("The checkpoint was written by a run on other data or with another configuration.");
+    }
+
+    const auto savedCentroids = checkpoint.getMatrix("Centroids");
+    if (savedCentroids.rows() != k || savedCentroids.columns() != d)
+    {
+      throw std::invalid_argument("The checkpoint does not match the number of clusters and the dimensions of the data.");
+    }
+  }
+
+  /**
+   * Restores the centroids and the assignments after an iteration and returns the index of the next iteration.
+   */
+  template <typename T>
+  size_t
+  restoreLloydsCheckpoint(const utils::Checkpoint &checkpoint, const utils::Checkpoint &runDescription, size_t maxIterations, blaze::DynamicMatrix<T> &centroids, ClusterAssignmentList &assignments)
+  {
+    checkLloydsCheckpoint(checkpoint, runDescription, centroids.rows(), centroids.columns());
+
+    centroids = checkpoint.getMatrix("Centroids");
+    assignments.loadFrom(checkpoint, "Assignments");
+
+    const size_t iteration = checkpoint.getInteger("Iteration");
+    KMEANS_LOG_INFO("Resuming k-Means from the checkpoint after iteration %ld", iteration);
+    return checkpoint.getInteger("Finished") != 0 ? maxIterations : iteration + 1;
+  }
 }
 
+KMeans::KMeans(uint k, bool kpp, bool precomputeDistances, uint miter, double convDiff, AssignmentMode mode, uint numThreads, uint numRestarts) : KMeans(k, kpp ? InitialisationMethod::KMeansPlusPlus : InitialisationMethod::Random, precomputeDistances, miter, convDiff, mode, numThreads, numRestarts)
+{
+}
+
+KMeans::KMeans(uint k, InitialisationMethod initMethod, bool precomputeDistances, uint miter, double convDiff, AssignmentMode mode, uint numThreads, uint numRestarts) : NumOfClusters(k), InitMethod(initMethod), PrecomputeDistances(precomputeDistances), MaxIterations(miter), ConvergenceDiff(convDiff), Mode(mode), NumThreads(numThreads), NumRestarts(std::max<uint>(1, numRestarts))
+{
+}
+
+template <typename T, typename AccumulatorT>
 std::shared_ptr<ClusteringResult>
-KMeans::run(const blaze::DynamicMatrix<double> &data)
+KMeans::run(const blaze::DynamicMatrix<T> &data)
 {
-  std::vector<size_t> initialCenters;
-  size_t k = this->NumOfClusters;
-  size_t n = data.rows();
-  size_t d = data.columns();
+  return this->runWithSeeding<T, AccumulatorT>(data, nullptr);
+}
 
-  if (this->InitKMeansPlusPlus)
+template <typename T, typename AccumulatorT>
+std::shared_ptr<ClusteringResult>
+KMeans::run(const blaze::DynamicMatrix<T> &data, const blaze::DynamicVector<double> &weights)
+{
+  if (this->InitMethod != InitialisationMethod::KMeansPlusPlus && this->InitMethod != InitialisationMethod::Random)
   {
-    initialCenters = this->pickInitialCentersViaKMeansPlusPlus(data, PrecomputeDistances);
+    throw std::invalid_argument("Only random and k-Means++ initialisation are supported for weighted data.");
   }
-  else
+
+  this->validatePointWeights(data.rows(), weights);
+  return this->runWithSeeding<T, AccumulatorT>(data, &weights);
+}
+
+template <typename T, typename AccumulatorT>
+std::shared_ptr<ClusteringResult>
+KMeans::runWithSeeding(const blaze::DynamicMatrix<T> &data, const blaze::DynamicVector<double> *pointWeights)
+{
+  // Data which only depends on the points is computed once and shared by the trials.
+  std::shared_ptr<PairwiseDistanceCache<T>> distanceCache;
+  if (this->InitMethod == InitialisationMethod::KMeansPlusPlus && PrecomputeDistances)
   {
-    utils::Random random;
+    // The distances of a point are computed when it becomes a center and only kept within the memory budget.
+    distanceCache = std::make_shared<PairwiseDistanceCache<T>>(data);
+  }
 
-    auto randomPointGenerator = random.getIndexer(n);
+  std::shared_ptr<const blaze::DynamicVector<T>> dataSquaredNorms;
+  if (this->Mode == AssignmentMode::Standard && !isFixedDimensionSupported(data.columns()) && !isSimdAssignmentSupported<T>(data.columns(), this->NumOfClusters))
+  {
+    dataSquaredNorms = std::make_shared<const blaze::DynamicVector<T>>(calcSquaredRowNorms(data));
+  }
 
-    for (size_t c = 0; c < k; c++)
+  // Checkpoints are read and validated here, so a checkpoint which cannot be resumed throws on the calling thread.
+  const auto checkpoints = this->readTrialCheckpoints(data, pointWeights);
+
+  auto result = this->runTrials([&](utils::Random &random, size_t numThreads, size_t trial)
+                         {
+                           // A resumed trial continues from its checkpoint instead of picking new centers.
+                           const auto trialCheckpointPath = this->getCheckpointPath(trial);
+                           const auto &checkpoint = checkpoints[trial];
+                           blaze::DynamicMatrix<T> centers(this->NumOfClusters, data.columns());
+                           if (checkpoint == nullptr)
+                           {
+                             auto initialCenters = this->pickInitialCenters(data, this->InitMethod, distanceCache, random, numThreads, pointWeights);
+                             centers = copyRows(data, initialCenters);
+                           }
+                           return this->runLloydsAlgorithm<T, AccumulatorT>(data, centers, dataSquaredNorms, numThreads, nullptr, trialCheckpointPath, checkpoint, pointWeights);
+                         });
+
+  this->removeCheckpoints();
+  return result;
+}
+
+template <typename T, typename AccumulatorT>
+std::shared_ptr<ClusteringResult>
+KMeans::run(const blaze::CompressedMatrix<T> &data)
+{
+  if (this->InitMethod != InitialisationMethod::KMeansPlusPlus && this->InitMethod != InitialisationMethod::Random)
+  {
+    throw std::invalid_argument("Only random and k-Means++ initialisation are supported for sparse data.");
+  }
+
+  const auto dataSquaredNorms = calcSquaredRowNorms(data);
+
+  // Checkpoints are read and validated here, so a checkpoint which cannot be resumed throws on the calling thread.
+  const auto checkpoints = this->readTrialCheckpoints(data, nullptr);
+
+  auto result = this->runTrials([&](utils::Random &random, size_t numThreads, size_t trial)
+                         {
+                           // A resumed trial continues from its checkpoint instead of picking new centers.
+                           const auto trialCheckpointPath = this->getCheckpointPath(trial);
+                           const auto &checkpoint = checkpoints[trial];
+                           blaze::DynamicMatrix<T> centers(this->NumOfClusters, data.columns());
+                           if (checkpoint == nullptr)
+                           {
+                             auto initialCenters = this->pickInitialCenters(data, this->InitMethod, random, numThreads);
+                             centers = copyRows(data, initialCenters);
+                           }
+                           return this->runLloydsAlgorithm<T, AccumulatorT>(data, centers, dataSquaredNorms, numThreads, nullptr, trialCheckpointPath, checkpoint);
+                         });
+
+  this->removeCheckpoints();
+  return result;
+}
+
+template <typename T, typename AccumulatorT>
+std::shared_ptr<ClusteringResult>
+KMeans::run(const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<double> &initialCentroids)
+{
+  this->validateWarmStart(data.rows(), data.columns(), initialCentroids, nullptr);
+
+  blaze::DynamicMatrix<T> centers(initialCentroids);
+  const auto firstCheckpointPath = this->getCheckpointPath(0);
+  auto result = this->runLloydsAlgorithm<T, AccumulatorT>(data, centers, nullptr, utils::resolveNumberOfThreads(this->NumThreads), nullptr, firstCheckpointPath, utils::readCheckpoint(firstCheckpointPath));
+  this->removeCheckpoints();
+  return result;
+}
+
+template <typename T, typename AccumulatorT>
+std::shared_ptr<ClusteringResult>
+KMeans::run(const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<double> &initialCentroids, const ClusterAssignmentList &previousAssignments)
+{
+  this->validateWarmStart(data.rows(), data.columns(), initialCentroids, &previousAssignments);
+
+  blaze::DynamicMatrix<T> centers(initialCentroids);
+  const auto firstCheckpointPath = this->getCheckpointPath(0);
+  auto result = this->runLloydsAlgorithm<T, AccumulatorT>(data, centers, nullptr, utils::resolveNumberOfThreads(this->NumThreads), &previousAssignments, firstCheckpointPath, utils::readCheckpoint(firstCheckpointPath));
+  this->removeCheckpoints();
+  return result;
+}
+
+template <typename T, typename AccumulatorT>
+std::shared_ptr<ClusteringResult>
+KMeans::run(const blaze::CompressedMatrix<T> &data, const blaze::DynamicMatrix<double> &initialCentroids)
+{
+  this->validateWarmStart(data.rows(), data.columns(), initialCentroids, nullptr);
+
+  blaze::DynamicMatrix<T> centers(initialCentroids);
+  const auto firstCheckpointPath = this->getCheckpointPath(0);
+  auto result = this->runLloydsAlgorithm<T, AccumulatorT>(data, centers, calcSquaredRowNorms(data), utils::resolveNumberOfThreads(this->NumThreads), nullptr, firstCheckpointPath, utils::readCheckpoint(firstCheckpointPath));
+  this->removeCheckpoints();
+  return result;
+}
+
+template <typename T, typename AccumulatorT>
+std::shared_ptr<ClusteringResult>
+KMeans::run(const blaze::CompressedMatrix<T> &data, const blaze::DynamicMatrix<double> &initialCentroids, const ClusterAssignmentList &previousAssignments)
+{
+  this->validateWarmStart(data.rows(), data.columns(), initialCentroids, &previousAssignments);
+
+  blaze::DynamicMatrix<T> centers(initialCentroids);
+  const auto firstCheckpointPath = this->getCheckpointPath(0);
+  auto result = this->runLloydsAlgorithm<T, AccumulatorT>(data, centers, calcSquaredRowNorms(data), utils::resolveNumberOfThreads(this->NumThreads), &previousAssignments, firstCheckpointPath, utils::readCheckpoint(firstCheckpointPath));
+  this->removeCheckpoints();
+  return result;
+}
+
+void
+KMeans::validateWarmStart(size_t n, size_t d, const blaze::DynamicMatrix<double> &initialCentroids, const ClusterAssignmentList *previousAssignments) const
+{
+  if (initialCentroids.rows() != this->NumOfClusters || initialCentroids.columns() != d)
+  {
+    throw std::invalid_argument("The initial centroids must be a KxD matrix with the dimensions of the data.");
+  }
+
+  if (previousAssignments != nullptr && (previousAssignments->getNumberOfClusters() != this->NumOfClusters || previousAssignments->getNumberOfPoints() > n))
+  {
+    throw std::invalid_argument("The previous assignments must have K clusters and cover at most the N points of the data.");
+  }
+}
+
+void
+KMeans::validatePointWeights(size_t n, const blaze::DynamicVector<double> &pointWeights) const
+{
+  if (pointWeights.size() != n)
+  {
+    throw std::invalid_argument("There must be one weight for each point.");
+  }
+
+  size_t numOfPositiveWeights = 0;
+  for (size_t p = 0; p < n; p++)
+  {
+    if (!std::isfinite(pointWeights[p]) || pointWeights[p] < 0.0)
+    {
+      throw std::invalid_argument("The weights of the points must be finite and non-negative.");
+    }
+
+    if (pointWeights[p] > 0.0)
+    {
+      numOfPositiveWeights++;
+    }
+  }
+
+  if (numOfPositiveWeights < this->NumOfClusters)
+  {
+    throw std::invalid_argument("At least K points must have a positive weight.");
+  }
+}
+
+void
+KMeans::enableCheckpoints(const std::string &filePath, size_t interval)
+{
+  this->checkpointPath = filePath;
+  this->checkpointInterval = std::max<size_t>(1, interval);
+}
+
+template <typename MatrixT>
+std::vector<std::shared_ptr<const utils::Checkpoint>>
+KMeans::readTrialCheckpoints(const MatrixT &data, const blaze::DynamicVector<double> *pointWeights) const
+{
+  std::vector<std::shared_ptr<const utils::Checkpoint>> checkpoints(this->NumRestarts);
+  utils::Checkpoint runDescription;
+  bool isDescribed = false;
+  for (size_t trial = 0; trial < this->NumRestarts; trial++)
+  {
+    auto checkpoint = utils::readCheckpoint(this->getCheckpointPath(trial));
+    if (checkpoint == nullptr)
     {
-      // Pick a random point p as a cluster center.
-      auto randomPoint = randomPointGenerator.next();
-      initialCenters.push_back(randomPoint);
+      continue;
     }
+
+    // The fingerprint of the data is only computed if there is a checkpoint to compare it with.
+    if (!isDescribed)
+    {
+      runDescription = describeLloydsRun(data, this->NumOfClusters, this->InitMethod, this->MaxIterations, pointWeights);
+      isDescribed = true;
+    }
+
+    checkLloydsCheckpoint(*checkpoint, runDescription, this->NumOfClusters, data.columns());
+    ClusterAssignmentList assignments(data.rows(), this->NumOfClusters);
+    assignments.loadFrom(*checkpoint, "Assignments");
+    // Reading the progress throws if the checkpoint is missing it.
+    static_cast<void>(checkpoint->getInteger("Iteration"));
+    static_cast<void>(checkpoint->getInteger("Finished"));
+
+    checkpoints[trial] = checkpoint;
+  }
+  return checkpoints;
+}
+
+void
+KMeans::removeCheckpoints() const
+{
+  for (size_t trial = 0; trial < this->NumRestarts; trial++)
+  {
+    utils::removeCheckpoint(this->getCheckpointPath(trial));
+  }
+}
+
+std::string
+KMeans::getCheckpointPath(size_t trial) const
+{
+  if (this->checkpointPath.empty() || this->NumRestarts == 1)
+  {
+    return this->checkpointPath;
+  }
+  return this->checkpointPath + "." + std::to_string(trial);
+}
+
+std::shared_ptr<ClusteringResult>
+KMeans::runTrials(const std::function<std::shared_ptr<ClusteringResult>(utils::Random &, size_t, size_t)> &runTrial)
+{
+  // Run as many trials at once as there are threads, and split the threads between them. The
+  // algorithms give the same result for any number of threads, so the split does not matter.
+  const size_t numThreads = utils::resolveNumberOfThreads(this->NumThreads);
+  const size_t numConcurrentTrials = std::min(this->NumRestarts, numThreads);
+  const size_t threadsPerTrial = std::max<size_t>(1, numThreads / numConcurrentTrials);
+
+  std::vector<std::shared_ptr<ClusteringResult>> results(this->NumRestarts);
+  utils::parallelFor(0, this->NumRestarts, numConcurrentTrials, [&](size_t beginTrial, size_t endTrial)
+                     {
+                       for (size_t trial = beginTrial; trial < endTrial; trial++)
+                       {
+                         // The first trial uses the same stream as a single run.
+                         utils::Random random(utils::DefaultRandomSeed, trial);
+                         results[trial] = runTrial(random, threadsPerTrial, trial);
+                       }
+                     });
+
+  // Ties are broken by the trial index so the result does not depend on the scheduling.
+  size_t bestTrial = 0;
+  for (size_t trial = 1; trial < results.size(); trial++)
+  {
+    if (results[trial]->getClusterAssignments().getTotalCost() < results[bestTrial]->getClusterAssignments().getTotalCost())
+    {
+      bestTrial = trial;
+    }
+  }
+
+  if (this->NumRestarts > 1)
+  {
+    KMEANS_LOG_INFO("Picked trial %ld of %ld with cost %0.5f", bestTrial, this->NumRestarts, results[bestTrial]->getClusterAssignments().getTotalCost());
+  }
+
+  return results[bestTrial];
+}
+
+template <typename T>
+std::vector<size_t>
+KMeans::pickInitialCenters(const blaze::DynamicMatrix<T> &matrix, InitialisationMethod initMethod, std::shared_ptr<PairwiseDistanceCache<T>> distanceCache, utils::Random &random, size_t numThreads,
+                           const blaze::DynamicVector<double> *pointWeights)
+{
+  if (initMethod == InitialisationMethod::KMeansPlusPlus)
+  {
+    // The seeder only computes distances to the newest center and works on a reference to the data.
+    KMeansPlusPlusSeeder<T> seeder(matrix, numThreads, distanceCache);
+    if (pointWeights != nullptr)
+    {
+      seeder.setPointWeights(*pointWeights);
+    }
+    return seeder.pickCenters(this->NumOfClusters, random);
+  }
+
+  if (pointWeights != nullptr)
+  {
+    return this->pickInitialCentersRandomly(*pointWeights, random);
+  }
+
+  if (initMethod == InitialisationMethod::KMeansParallel)
+  {
+    KMeansParallelInitialiser<T> initialiser(matrix, numThreads);
+    return initialiser.pickCenters(this->NumOfClusters, random);
+  }
+
+  if (initMethod == InitialisationMethod::AFKMC2)
+  {
+    AFKMC2Initialiser<T> initialiser(matrix, numThreads);
+    return initialiser.pickCenters(this->NumOfClusters, random);
+  }
+
+  return this->pickInitialCentersRandomly(matrix.rows(), random);
+}
+
+template <typename T>
+std::vector<size_t>
+KMeans::pickInitialCenters(const blaze::CompressedMatrix<T> &matrix, InitialisationMethod initMethod, utils::Random &random, size_t numThreads)
+{
+  if (initMethod == InitialisationMethod::KMeansPlusPlus)
+  {
+    // Distances between sparse points only visit their nonzero entries.
+    KMeansPlusPlusSeeder<T, blaze::CompressedMatrix<T>> seeder(matrix, numThreads);
+    return seeder.pickCenters(this->NumOfClusters, random);
+  }
+
+  return this->pickInitialCentersRandomly(matrix.rows(), random);
+}
+
+std::vector<size_t>
+KMeans::pickInitialCentersRandomly(size_t n, utils::Random &random)
+{
+  std::vector<size_t> initialCenters;
+
+  auto randomPointGenerator = random.getIndexer(n);
+
+  for (size_t c = 0; c < this->NumOfClusters; c++)
+  {
+    // Pick a random point p as a cluster center.
+    auto randomPoint = randomPointGenerator.next();
+    initialCenters.push_back(randomPoint);
+  }
+
+  return initialCenters;
+}
+
+std::vector<size_t>
+KMeans::pickInitialCentersRandomly(const blaze::DynamicVector<double> &pointWeights, utils::Random &random)
+{
+  std::vector<size_t> initialCenters;
+  utils::WeightedSampler pointSampler(pointWeights);
+
+  for (size_t c = 0; c < this->NumOfClusters; c++)
+  {
+    // Drop the picked point from the sampler so the centers are distinct.
+    auto randomPoint = random.choice(pointSampler);
+    pointSampler.update(randomPoint, 0.0);
+    initialCenters.push_back(randomPoint);
   }
 
-  auto centers = copyRows(data, initialCenters);
-  return this->runLloydsAlgorithm(data, centers);
+  return initialCenters;
 }
 
-blaze::DynamicMatrix<double>
-KMeans::copyRows(const blaze::DynamicMatrix<double> &data, const std::vector<size_t> &indicesToCopy)
+template <typename T>
+blaze::DynamicMatrix<T>
+KMeans::copyRows(const blaze::DynamicMatrix<T> &data, const std::vector<size_t> &indicesToCopy)
 {
   size_t k = indicesToCopy.size();
   size_t d = data.columns();
 
-  blaze::DynamicMatrix<double> centers(k, d);
+  blaze::DynamicMatrix<T> centers(k, d);
   for (size_t c = 0; c < k; c++)
   {
     size_t pointIndex = indicesToCopy[c];
@@ -51,179 +472,473 @@ KMeans::copyRows(const blaze::DynamicMatrix<double> &data, const std::vector<siz
   return centers;
 }
 
+template <typename T>
+blaze::DynamicMatrix<T>
+KMeans::copyRows(const blaze::CompressedMatrix<T> &data, const std::vector<size_t> &indicesToCopy)
+{
+  size_t k = indicesToCopy.size();
+  size_t d = data.columns();
+
+  blaze::DynamicMatrix<T> centers(k, d, T(0));
+  for (size_t c = 0; c < k; c++)
+  {
+    size_t pointIndex = indicesToCopy[c];
+    for (auto it = data.begin(pointIndex); it != data.end(pointIndex); ++it)
+    {
+      centers(c, it->index()) = it->value();
+    }
+  }
+  return centers;
+}
+
+template <typename T>
+std::vector<size_t>
+KMeans::pickInitialCentersViaKMeansPlusPlus(const blaze::DynamicMatrix<T> &matrix, const bool usePrecomputeDistances)
+{
+  std::shared_ptr<PairwiseDistanceCache<T>> distanceCache;
+
+  if (usePrecomputeDistances)
+  {
+    // The distances of a point are computed when it becomes a center and only kept within the memory budget.
+    distanceCache = std::make_shared<PairwiseDistanceCache<T>>(matrix);
+  }
+
+  return this->pickInitialCentersViaKMeansPlusPlus(matrix, distanceCache);
+}
+
+template <typename T>
+std::vector<size_t>
+KMeans::pickInitialCentersViaKMeansPlusPlus(const blaze::DynamicMatrix<T> &matrix, std::shared_ptr<PairwiseDistanceCache<T>> distanceCache)
+{
+  utils::Random random;
+  return this->pickInitialCenters(matrix, InitialisationMethod::KMeansPlusPlus, distanceCache, random, this->NumThreads);
+}
+
+template <typename T>
 std::vector<size_t>
-KMeans::pickInitialCentersViaKMeansPlusPlus(const blaze::DynamicMatrix<double> &matrix, const bool usePrecomputeDistances)
+KMeans::pickInitialCentersViaKMeansPlusPlus(const blaze::DynamicMatrix<T> &matrix, const blaze::DynamicVector<double> &weights)
 {
+  this->validatePointWeights(matrix.rows(), weights);
+
   utils::Random random;
+  return this->pickInitialCenters<T>(matrix, InitialisationMethod::KMeansPlusPlus, nullptr, random, this->NumThreads, &weights);
+}
+
+template <typename T>
+std::vector<size_t>
+KMeans::pickInitialCentersViaKMeansPlusPlus(const blaze::CompressedMatrix<T> &matrix)
+{
+  utils::Random random;
+  return this->pickInitialCenters(matrix, InitialisationMethod::KMeansPlusPlus, random, this->NumThreads);
+}
+
+template <typename T>
+std::vector<size_t>
+KMeans::pickInitialCentersViaKMeansParallel(const blaze::DynamicMatrix<T> &matrix)
+{
+  utils::Random random;
+  return this->pickInitialCenters<T>(matrix, InitialisationMethod::KMeansParallel, nullptr, random, this->NumThreads);
+}
+
+template <typename T>
+std::vector<size_t>
+KMeans::pickInitialCentersViaAFKMC2(const blaze::DynamicMatrix<T> &matrix)
+{
+  utils::Random random;
+  return this->pickInitialCenters<T>(matrix, InitialisationMethod::AFKMC2, nullptr, random, this->NumThreads);
+}
+
+template <typename T, typename AccumulatorT>
+std::shared_ptr<ClusteringResult>
+KMeans::runLloydsAlgorithm(const blaze::DynamicMatrix<T> &matrix, blaze::DynamicMatrix<T> centroids, std::shared_ptr<const blaze::DynamicVector<T>> dataSquaredNorms, size_t numThreads, const ClusterAssignmentList *previousAssignments,
+                           const std::string &checkpointFilePath, std::shared_ptr<const utils::Checkpoint> resumeFrom, const blaze::DynamicVector<double> *pointWeights)
+{
   size_t n = matrix.rows();
   size_t d = matrix.columns();
   size_t k = this->NumOfClusters;
 
-  blaze::DynamicMatrix<double> pairwiseDist;
+  blaze::DynamicVector<size_t> clusterMemberCounts(k);
+  ClusterAssignmentList cal(n, k);
+  if (pointWeights != nullptr)
+  {
+    cal.setPointWeights(*pointWeights);
+  }
 
-  if (usePrecomputeDistances)
+  // The engine may keep state, such as distance bounds, between iterations.
+  auto assignmentEngine = createAssignmentEngine<T>(this->Mode, n, k, numThreads, dataSquaredNorms);
+
+  // Centroid sums are accumulated per row partition and reduced in partition order. Since the
+  // partitions only depend on N, K and D, the result is identical for any number of threads.
+  // The partition sums are allocated on first use, so they cost nothing while the engine keeps the sums.
+  const size_t numPartitions = getNumberOfAccumulatorPartitions(n, k * d * sizeof(AccumulatorT));
+  std::vector<blaze::DynamicMatrix<AccumulatorT>> partitionSums;
+  blaze::DynamicMatrix<AccumulatorT> centroidSums(k, d);
+  std::vector<blaze::DynamicVector<size_t>> partitionCounts;
+  blaze::DynamicMatrix<double> engineCentroidSums;
+
+  // Weighted points contribute their weight instead of a count to the size of their cluster.
+  std::vector<blaze::DynamicVector<double>> partitionWeights;
+  blaze::DynamicVector<double> clusterWeights(k);
+
+  // Checkpoints are tied to the data and the configuration, so a checkpoint of another run is never resumed.
+  utils::Checkpoint runDescription;
+  if (!checkpointFilePath.empty())
+  {
+    runDescription = describeLloydsRun(matrix, k, this->InitMethod, this->MaxIterations, pointWeights);
+  }
+
+  size_t firstIteration = 0;
+  if (resumeFrom != nullptr)
   {
-    // Compute squared pairwise distances between points.
-    printf("Precomputing pairwise squared distances between all points!\n");
+    firstIteration = restoreLloydsCheckpoint(*resumeFrom, runDescription, this->MaxIterations, centroids, cal);
+    previousAssignments = nullptr;
+  }
 
-    auto M = matrix * blaze::trans(matrix);
-    blaze::DynamicVector<double> diagM(n);
-    diagM = blaze::diagonal(M);
-    blaze::DynamicVector<double> ones(n);
-    ones = 1;
-    auto h = diagM * blaze::trans(ones);
-    pairwiseDist = h + blaze::trans(h) - 2 * M;
+  // Snapshots are taken between iterations and written on a background thread.
+  std::unique_ptr<utils::CheckpointWriter> checkpointWriter;
+  if (!checkpointFilePath.empty())
+  {
+    checkpointWriter = std::make_unique<utils::CheckpointWriter>(checkpointFilePath);
   }
 
-  // Lambda function computes the squared L2 distance between any pair of points.
-  // The function will automatically use any precomputed distance if it exists.
-  auto calcSquaredL2Norm = [matrix, pairwiseDist, usePrecomputeDistances](size_t p1, size_t p2) -> double
+  bool hasEngineAssigned = false;
+  size_t lastIteration = firstIteration;
+
+  for (size_t i = firstIteration; i < this->MaxIterations; i++)
   {
-    if (p1 == p2)
+    // A warm start keeps the previous assignments in the first iteration so only the new points are visited.
+    const bool isWarmStartIteration = i == 0 && previousAssignments != nullptr;
+    if (isWarmStartIteration)
     {
-      return 0.0;
-    }
+      const size_t m = previousAssignments->getNumberOfPoints();
+      for (size_t p = 0; p < m; p++)
+      {
+        cal.assign(p, previousAssignments->getCluster(p), previousAssignments->getPointCost(p));
+      }
+
+      if (isSimdAssignmentSupported<T>(d, k))
+      {
+        utils::parallelFor(m, n, numThreads, [&](size_t beginPoint, size_t endPoint)
+                           { assignClosestCentersSimd(matrix, centroids, cal, beginPoint, endPoint); });
+      }
+      else if (isFixedDimensionSupported(d))
+      {
+        utils::parallelFor(m, n, numThreads, [&](size_t beginPoint, size_t endPoint)
+                           { assignClosestCentersFixedDimension(matrix, centroids, cal, beginPoint, endPoint); });
+      }
+      else
+      {
+        // Only the norms of the new points are read.
+        blaze::DynamicVector<T> newSquaredNorms;
+        if (dataSquaredNorms == nullptr)
+        {
+          newSquaredNorms = blaze::DynamicVector<T>(n, T(0));
+          for (size_t p = m; p < n; p++)
+          {
+            newSquaredNorms[p] = blaze::sqrNorm(blaze::row(matrix, p));
+          }
+        }
+        const auto &squaredNorms = dataSquaredNorms != nullptr ? *dataSquaredNorms : newSquaredNorms;
 
-    if (usePrecomputeDistances)
+        utils::parallelFor(m, n, numThreads, [&](size_t beginPoint, size_t endPoint)
+                           { assignClosestCentersBlocked(matrix, squaredNorms, centroids, cal, beginPoint, endPoint); });
+      }
+    }
+    else
     {
-      return pairwiseDist.at(p1, p2);
+      // For each data point, assign the centroid that is closest to it.
+      assignmentEngine->assign(matrix, centroids, cal);
+      hasEngineAssigned = true;
     }
 
-    return blaze::sqrNorm(blaze::row(matrix, p1) - blaze::row(matrix, p2));
-  };
-
-  // Track which points are picked as centers.
-  std::vector<size_t> pickedPointsAsCenters;
-  pickedPointsAsCenters.reserve(k);
+    // Move centroids based on the cluster assignments.
 
-  for (size_t c = 0; c < k; c++)
-  {
-    size_t centerIndex = 0;
+    // First, save a copy of the centroids matrix.
+    blaze::DynamicMatrix<T> oldCentrioids(centroids);
 
-    if (c == 0)
+    // The engines only keep unweighted sums.
+    if (!isWarmStartIteration && pointWeights == nullptr && assignmentEngine->getCentroidSums(engineCentroidSums, clusterMemberCounts))
+    {
+      // The engine summed up the points without visiting all of them.
+      centroidSums = engineCentroidSums;
+    }
+    else if (pointWeights != nullptr)
     {
-      // Pick the first centroid uniformly at random.
-      auto randomPointGenerator = random.getIndexer(n);
-      centerIndex = randomPointGenerator.next();
+      partitionSums.resize(numPartitions, blaze::DynamicMatrix<AccumulatorT>(k, d));
+      partitionWeights.resize(numPartitions, blaze::DynamicVector<double>(k));
+      utils::parallelForPartitions(0, n, numPartitions, numThreads, [&](size_t partition, size_t beginPoint, size_t endPoint)
+                                   {
+                                     auto &sums = partitionSums[partition];
+                                     auto &weights = partitionWeights[partition];
+                                     sums = 0;
+                                     weights = 0;
+
+                                     for (size_t p = beginPoint; p < endPoint; p++)
+                                     {
+                                       const size_t c = cal.getCluster(p);
+                                       const double weight = (*pointWeights)[p];
+                                       blaze::row(sums, c) += static_cast<AccumulatorT>(weight) * blaze::row(matrix, p);
+                                       weights[c] += weight;
+                                     }
+                                   });
+
+      centroidSums = 0;
+      clusterWeights = 0;
+
+      for (size_t partition = 0; partition < numPartitions; partition++)
+      {
+        centroidSums += partitionSums[partition];
+        clusterWeights += partitionWeights[partition];
+      }
     }
     else
     {
-      blaze::DynamicVector<double> weights(n);
-      for (size_t p1 = 0; p1 < n; p1++)
+      partitionSums.resize(numPartitions, blaze::DynamicMatrix<AccumulatorT>(k, d));
+      partitionCounts.resize(numPartitions, blaze::DynamicVector<size_t>(k));
+      utils::parallelForPartitions(0, n, numPartitions, numThreads, [&](size_t partition, size_t beginPoint, size_t endPoint)
+                                   {
+                                     auto &sums = partitionSums[partition];
+                                     auto &counts = partitionCounts[partition];
+                                     sums = 0;
+                                     counts = 0;
+
+                                     for (size_t p = beginPoint; p < endPoint; p++)
+                                     {
+                                       const size_t c = cal.getCluster(p);
+                                       blaze::row(sums, c) += blaze::row(matrix, p);
+                                       counts[c] += 1;
+                                     }
+                                   });
+
+      // Set all elements to zero.
+      centroidSums = 0;        // Reset centroid sums.
+      clusterMemberCounts = 0; // Reset cluster member counts.
+
+      for (size_t partition = 0; partition < numPartitions; partition++)
       {
-        double smallestDistance = std::numeric_limits<double>::max();
+        centroidSums += partitionSums[partition];
+        clusterMemberCounts += partitionCounts[partition];
+      }
+    }
 
-        // Loop through previously selected clusters.
-        for (size_t p2 : pickedPointsAsCenters)
-        {
-          // Notice that for points previously picked as centers, their
-          // distances will be zero because the diagonal elements of the
-          // pairwise distance matrix are all zeros: D^2[i,i] = 0.
-          double distance = calcSquaredL2Norm(p1, p2);
+    for (size_t c = 0; c < k; c++)
+    {
+      if (pointWeights != nullptr)
+      {
+        // Clusters without weight keep a zero sum, like empty clusters.
+        const double weight = clusterWeights[c] > 0.0 ? clusterWeights[c] : 1.0;
+        blaze::row(centroidSums, c) /= static_cast<AccumulatorT>(weight);
+        continue;
+      }
 
-          // Decide if current distance is better.
-          if (distance < smallestDistance)
-          {
-            smallestDistance = distance;
-          }
-        }
+      const auto count = std::max<size_t>(1, clusterMemberCounts[c]);
+      blaze::row(centroidSums, c) /= static_cast<AccumulatorT>(count);
+    }
 
-        // Set the weight of a given point to be the smallest distance
-        // to any of the previously selected center points. We want to
-        // select points randomly such that points that are far from
-        // any of the selected center points have higher likelihood of
-        // being picked as the next candidate center.
-        weights[p1] = smallestDistance;
-      }
+    // Round the means to the precision of the data only after they are computed.
+    centroids = centroidSums;
+
+    KMEANS_LOG_TRACE("Centroids after iteration %ld:\n%s", i, utils::toString(centroids).c_str());
+
+    // Compute the Frobenius norm
+    auto diffAbsMatrix = blaze::abs(centroids - oldCentrioids);
+    auto diffAbsSquaredMatrix = blaze::pow(diffAbsMatrix, 2); // Square each element.
+    auto frobeniusNormDiff = blaze::sqrt(blaze::sum(diffAbsSquaredMatrix));
 
-      // Normalise the weights.
-      weights /= blaze::sum(weights);
+    KMEANS_LOG_DEBUG("Frobenius norm of centroids difference after iteration %ld: %g", i, static_cast<double>(frobeniusNormDiff));
 
-      // Pick the index of a point randomly selected based on the weights.
-      centerIndex = random.choice(weights);
+    lastIteration = i;
+    if (static_cast<double>(frobeniusNormDiff) < this->ConvergenceDiff)
+    {
+      KMEANS_LOG_INFO("Stopping k-Means as centroids do not improve. Frobenius norm Diff: %g", static_cast<double>(frobeniusNormDiff));
+      break;
     }
 
-    std::cout << "Center index for " << c << " => " << centerIndex << "\n";
-    pickedPointsAsCenters.push_back(centerIndex);
+    if (checkpointWriter != nullptr && (i + 1) % this->checkpointInterval == 0 && i + 1 < this->MaxIterations)
+    {
+      checkpointWriter->write(makeLloydsCheckpoint(runDescription, i, false, centroids, cal));
+    }
   }
 
-  return pickedPointsAsCenters;
+  // Bounded assignment engines may store upper bounds instead of exact costs.
+  if (hasEngineAssigned)
+  {
+    assignmentEngine->finalise(matrix, cal);
+  }
+
+  if (checkpointWriter != nullptr && firstIteration < this->MaxIterations && this->NumRestarts > 1)
+  {
+    // The final state lets an interrupted run with restarts skip the trials which had finished. It is
+    // saved after the costs are exact, so resuming a finished trial returns the same result.
+    checkpointWriter->write(makeLloydsCheckpoint(runDescription, lastIteration, true, centroids, cal));
+  }
+
+  blaze::DynamicMatrix<double> finalCentroids(centroids);
+  return std::make_shared<ClusteringResult>(cal, finalCentroids);
 }
 
+template <typename T, typename AccumulatorT>
 std::shared_ptr<ClusteringResult>
-KMeans::runLloydsAlgorithm(const blaze::DynamicMatrix<double> &matrix, blaze::DynamicMatrix<double> centroids)
+KMeans::runLloydsAlgorithm(const blaze::CompressedMatrix<T> &matrix, blaze::DynamicMatrix<T> centroids, const blaze::DynamicVector<T> &dataSquaredNorms, size_t numThreads, const ClusterAssignmentList *previousAssignments,
+                           const std::string &checkpointFilePath, std::shared_ptr<const utils::Checkpoint> resumeFrom)
 {
   size_t n = matrix.rows();
+  size_t d = matrix.columns();
   size_t k = this->NumOfClusters;
 
-  blaze::DynamicVector<size_t> clusterMemberCounts(k);
   ClusterAssignmentList cal(n, k);
 
-  for (size_t i = 0; i < this->MaxIterations; i++)
+  // A dense accumulator per row partition would need O(K*D) memory per partition, so the sums are
+  // accumulated per cluster instead, in the order of the points. This is identical for any number of threads.
+  std::vector<std::vector<size_t>> clusterMembers(k);
+  blaze::DynamicMatrix<AccumulatorT> centroidSums(k, d);
+
+  // The centroids are transposed once per iteration and shared by all threads.
+  blaze::DynamicMatrix<T> transposedCentroids(d, k);
+  blaze::DynamicVector<T> centroidSquaredNorms(k);
+
+  // Checkpoints are tied to the data and the configuration, so a checkpoint of another run is never resumed.
+  utils::Checkpoint runDescription;
+  if (!checkpointFilePath.empty())
   {
-    // For each data point, assign the centroid that is closest to it.
-    for (size_t p = 0; p < n; p++)
-    {
-      double bestDistance = std::numeric_limits<double>::max();
-      size_t bestCluster = 0;
+    runDescription = describeLloydsRun(matrix, k, this->InitMethod, this->MaxIterations, nullptr);
+  }
 
-      // Loop through all the clusters.
-      for (size_t c = 0; c < k; c++)
-      {
+  size_t firstIteration = 0;
+  if (resumeFrom != nullptr)
+  {
+    firstIteration = restoreLloydsCheckpoint(*resumeFrom, runDescription, this->MaxIterations, centroids, cal);
+    previousAssignments = nullptr;
+  }
 
-        // Compute the L2 norm between point p and centroid c.
-        const double distance = blaze::norm(blaze::row(matrix, p) - blaze::row(centroids, c));
+  // Snapshots are taken between iterations and written on a background thread.
+  std::unique_ptr<utils::CheckpointWriter> checkpointWriter;
+  if (!checkpointFilePath.empty())
+  {
+    checkpointWriter = std::make_unique<utils::CheckpointWriter>(checkpointFilePath);
+  }
 
-        // Decide if current distance is better.
-        if (distance < bestDistance)
-        {
-          bestDistance = distance;
-          bestCluster = c;
-        }
-      }
+  size_t lastIteration = firstIteration;
 
-      // Assign cluster to the point p.
-      cal.assign(p, bestCluster, bestDistance);
+  for (size_t i = firstIteration; i < this->MaxIterations; i++)
+  {
+    // A warm start keeps the previous assignments in the first iteration so only the new points are visited.
+    size_t firstPointToAssign = 0;
+    if (i == 0 && previousAssignments != nullptr)
+    {
+      firstPointToAssign = previousAssignments->getNumberOfPoints();
+      for (size_t p = 0; p < firstPointToAssign; p++)
+      {
+        cal.assign(p, previousAssignments->getCluster(p), previousAssignments->getPointCost(p));
+      }
     }
 
+    // For each data point, assign the centroid that is closest to it.
+    prepareSparseAssignmentCenters(centroids, transposedCentroids, centroidSquaredNorms);
+    utils::parallelFor(firstPointToAssign, n, numThreads, [&](size_t beginPoint, size_t endPoint)
+                       { assignClosestCentersSparse(matrix, dataSquaredNorms, transposedCentroids, centroidSquaredNorms, cal, beginPoint, endPoint); });
+
     // Move centroids based on the cluster assignments.
 
     // First, save a copy of the centroids matrix.
-    blaze::DynamicMatrix<double> oldCentrioids(centroids);
-
-    // Set all elements to zero.
-    centroids = 0;           // Reset centroids.
-    clusterMemberCounts = 0; // Reset cluster member counts.
+    blaze::DynamicMatrix<T> oldCentrioids(centroids);
 
-    for (size_t p = 0; p < n; p++)
+    for (auto &members : clusterMembers)
     {
-      const size_t c = cal.getCluster(p);
-      blaze::row(centroids, c) += blaze::row(matrix, p);
-      clusterMemberCounts[c] += 1;
+      members.clear();
     }
-
-    for (size_t c = 0; c < k; c++)
+    for (size_t p = 0; p < n; p++)
     {
-      const auto count = std::max<size_t>(1, clusterMemberCounts[c]);
-      blaze::row(centroids, c) /= count;
+      clusterMembers[cal.getCluster(p)].push_back(p);
     }
 
-    std::cout << "Centroids after iteration " << i << ": \n"
-              << centroids << "\n";
+    utils::parallelFor(0, k, numThreads, [&](size_t beginCluster, size_t endCluster)
+                       {
+                         for (size_t c = beginCluster; c < endCluster; c++)
+                         {
+                           blaze::row(centroidSums, c) = 0;
+                           for (size_t p : clusterMembers[c])
+                           {
+                             for (auto it = matrix.begin(p); it != matrix.end(p); ++it)
+                             {
+                               centroidSums(c, it->index()) += static_cast<AccumulatorT>(it->value());
+                             }
+                           }
+
+                           const auto count = std::max<size_t>(1, clusterMembers[c].size());
+                           blaze::row(centroidSums, c) /= static_cast<AccumulatorT>(count);
+                         }
+                       });
+
+    // Round the means to the precision of the data only after they are computed.
+    centroids = centroidSums;
 
     // Compute the Frobenius norm
     auto diffAbsMatrix = blaze::abs(centroids - oldCentrioids);
     auto diffAbsSquaredMatrix = blaze::pow(diffAbsMatrix, 2); // Square each element.
     auto frobeniusNormDiff = blaze::sqrt(blaze::sum(diffAbsSquaredMatrix));
 
-    std::cout << "Frobenius norm of centroids difference: " << frobeniusNormDiff << "!\n";
+    KMEANS_LOG_DEBUG("Frobenius norm of centroids difference after iteration %ld: %g", i, static_cast<double>(frobeniusNormDiff));
 
-    if (frobeniusNormDiff < this->ConvergenceDiff)
+    lastIteration = i;
+    if (static_cast<double>(frobeniusNormDiff) < this->ConvergenceDiff)
     {
-      std::cout << "Stopping k-Means as centroids do not improve. Frobenius norm Diff: " << frobeniusNormDiff << "\n";
+      KMEANS_LOG_INFO("Stopping k-Means as centroids do not improve. Frobenius norm Diff: %g", static_cast<double>(frobeniusNormDiff));
       break;
     }
+
+    if (checkpointWriter != nullptr && (i + 1) % this->checkpointInterval == 0 && i + 1 < this->MaxIterations)
+    {
+      checkpointWriter->write(makeLloydsCheckpoint(runDescription, i, false, centroids, cal));
+    }
   }
 
-  return std::make_shared<ClusteringResult>(cal, centroids);
+  if (checkpointWriter != nullptr && firstIteration < this->MaxIterations && this->NumRestarts > 1)
+  {
+    // The final state lets an interrupted run with restarts skip the trials which had finished.
+    checkpointWriter->write(makeLloydsCheckpoint(runDescription, lastIteration, true, centroids, cal));
+  }
+
+  blaze::DynamicMatrix<double> finalCentroids(centroids);
+  return std::make_shared<ClusteringResult>(cal, finalCentroids);
 }
+
+template std::shared_ptr<ClusteringResult> KMeans::run<float, float>(const blaze::DynamicMatrix<float> &);
+template std::shared_ptr<ClusteringResult> KMeans::run<float, double>(const blaze::DynamicMatrix<float> &);
+template std::shared_ptr<ClusteringResult> KMeans::run<double, double>(const blaze::DynamicMatrix<double> &);
+template std::shared_ptr<ClusteringResult> KMeans::run<float, float>(const blaze::DynamicMatrix<float> &, const blaze::DynamicVector<double> &);
+template std::shared_ptr<ClusteringResult> KMeans::run<float, double>(const blaze::DynamicMatrix<float> &, const blaze::DynamicVector<double> &);
+template std::shared_ptr<ClusteringResult> KMeans::run<double, double>(const blaze::DynamicMatrix<double> &, const blaze::DynamicVector<double> &);
+template std::shared_ptr<ClusteringResult> KMeans::run<float, float>(const blaze::CompressedMatrix<float> &);
+template std::shared_ptr<ClusteringResult> KMeans::run<float, double>(const blaze::CompressedMatrix<float> &);
+template std::shared_ptr<ClusteringResult> KMeans::run<double, double>(const blaze::CompressedMatrix<double> &);
+template std::shared_ptr<ClusteringResult> KMeans::run<float, float>(const blaze::DynamicMatrix<float> &, const blaze::DynamicMatrix<double> &);
+template std::shared_ptr<ClusteringResult> KMeans::run<float, double>(const blaze::DynamicMatrix<float> &, const blaze::DynamicMatrix<double> &);
+template std::shared_ptr<ClusteringResult> KMeans::run<double, double>(const blaze::DynamicMatrix<double> &, const blaze::DynamicMatrix<double> &);
+template std::shared_ptr<ClusteringResult> KMeans::run<float, float>(const blaze::DynamicMatrix<float> &, const blaze::DynamicMatrix<double> &, const ClusterAssignmentList &);
+template std::shared_ptr<ClusteringResult> KMeans::run<float, double>(const blaze::DynamicMatrix<float> &, const blaze::DynamicMatrix<double> &, const ClusterAssignmentList &);
+template std::shared_ptr<ClusteringResult> KMeans::run<double, double>(const blaze::DynamicMatrix<double> &, const blaze::DynamicMatrix<double> &, const ClusterAssignmentList &);
+template std::shared_ptr<ClusteringResult> KMeans::run<float, float>(const blaze::CompressedMatrix<float> &, const blaze::DynamicMatrix<double> &);
+template std::shared_ptr<ClusteringResult> KMeans::run<float, double>(const blaze::CompressedMatrix<float> &, const blaze::DynamicMatrix<double> &);
+template std::shared_ptr<ClusteringResult> KMeans::run<double, double>(const blaze::CompressedMatrix<double> &, const blaze::DynamicMatrix<double> &);
+template std::shared_ptr<ClusteringResult> KMeans::run<float, float>(const blaze::CompressedMatrix<float> &, const blaze::DynamicMatrix<double> &, const ClusterAssignmentList &);
+template std::shared_ptr<ClusteringResult> KMeans::run<float, double>(const blaze::CompressedMatrix<float> &, const blaze::DynamicMatrix<double> &, const ClusterAssignmentList &);
+template std::shared_ptr<ClusteringResult> KMeans::run<double, double>(const blaze::CompressedMatrix<double> &, const blaze::DynamicMatrix<double> &, const ClusterAssignmentList &);
+
+template std::vector<size_t> KMeans::pickInitialCentersViaKMeansPlusPlus(const blaze::DynamicMatrix<float> &, const bool);
+template std::vector<size_t> KMeans::pickInitialCentersViaKMeansPlusPlus(const blaze::DynamicMatrix<double> &, const bool);
+template std::vector<size_t> KMeans::pickInitialCentersViaKMeansPlusPlus(const blaze::DynamicMatrix<float> &, std::shared_ptr<PairwiseDistanceCache<float>>);
+template std::vector<size_t> KMeans::pickInitialCentersViaKMeansPlusPlus(const blaze::DynamicMatrix<double> &, std::shared_ptr<PairwiseDistanceCache<double>>);
+template std::vector<size_t> KMeans::pickInitialCentersViaKMeansPlusPlus(const blaze::DynamicMatrix<float> &, const blaze::DynamicVector<double> &);
+template std::vector<size_t> KMeans::pickInitialCentersViaKMeansPlusPlus(const blaze::DynamicMatrix<double> &, const blaze::DynamicVector<double> &);
+template std::vector<size_t> KMeans::pickInitialCentersViaKMeansPlusPlus(const blaze::CompressedMatrix<float> &);
+template std::vector<size_t> KMeans::pickInitialCentersViaKMeansPlusPlus(const blaze::CompressedMatrix<double> &);
+template std::vector<size_t> KMeans::pickInitialCentersViaKMeansParallel(const blaze::DynamicMatrix<float> &);
+template std::vector<size_t> KMeans::pickInitialCentersViaKMeansParallel(const blaze::DynamicMatrix<double> &);
+template std::vector<size_t> KMeans::pickInitialCentersViaAFKMC2(const blaze::DynamicMatrix<float> &);
+template std::vector<size_t> KMeans::pickInitialCentersViaAFKMC2(const blaze::DynamicMatrix<double> &);
+
+template blaze::DynamicMatrix<float> KMeans::copyRows(const blaze::DynamicMatrix<float> &, const std::vector<size_t> &);
+template blaze::DynamicMatrix<double> KMeans::copyRows(const blaze::DynamicMatrix<double> &, const std::vector<size_t> &);
+template blaze::DynamicMatrix<float> KMeans::copyRows(const blaze::CompressedMatrix<float> &, const std::vector<size_t> &);
+template blaze::DynamicMatrix<double> KMeans::copyRows(const blaze::CompressedMatrix<double> &, const std::vector<size_t> &);
@@ -0,0 +1,128 @@
+#include <clustering/kmeans_parallel.hpp>
+
+using namespace clustering;
+
+template <typename T>
+KMeansParallelInitialiser<T>::KMeansParallelInitialiser(const blaze::DynamicMatrix<T> &matrix, size_t numThreads, size_t numRounds, double oversamplingFactor) : data(matrix), NumThreads(numThreads), NumRounds(numRounds), OversamplingFactor(oversamplingFactor),
+                                                                                                                                                               dataSquaredNorms(calcSquaredRowNorms(matrix)), minSquaredDistances(matrix.rows())
+{
+}
+
+template <typename T>
+std::vector<size_t>
+KMeansParallelInitialiser<T>::pickCenters(size_t k, utils::Random &random)
+{
+    const size_t n = data.rows();
+    const double expectedSamplesPerRound = OversamplingFactor * static_cast<double>(k);
+
+    // Pick the first candidate uniformly at random.
+    auto randomPointGenerator = random.getIndexer(n);
+    std::vector<size_t> candidates{randomPointGenerator.next()};
+
+    minSquaredDistances = std::numeric_limits<double>::max();
+    updateDistances(candidates);
+
+    for (size_t round = 0; round < NumRounds; round++)
+    {
+        const double cost = blaze::sum(minSquaredDistances);
+        if (cost <= 0.0)
+        {
+            // Every point coincides with a candidate.
+            break;
+        }
+
+        // Sample each point independently with probability min(1, l*D^2(p)/cost). The draws are
+        // sequential so the candidates do not depend on the number of threads.
+        std::vector<size_t> newCandidates;
+        for (size_t p = 0; p < n; p++)
+        {
+            if (random.getDouble() * cost < expectedSamplesPerRound * minSquaredDistances[p])
+            {
+                newCandidates.push_back(p);
+            }
+        }
+
+        KMEANS_LOG_DEBUG("k-Means|| round %ld sampled %ld candidates", round, newCandidates.size());
+
+        updateDistances(newCandidates);
+        candidates.insert(candidates.end(), newCandidates.begin(), newCandidates.end());
+    }
+
+    // Top up with random points on tiny or degenerate datasets.
+    while (candidates.size() < k)
+    {
+        candidates.push_back(randomPointGenerator.next());
+    }
+
+    // Weigh each candidate by the number of points closest to it.
+    ClusterAssignmentList candidateAssignments(n, candidates.size());
+    assignToCandidates(candidates, candidateAssignments);
+
+    blaze::DynamicVector<double> candidateWeights(candidates.size(), 0.0);
+    for (size_t p = 0; p < n; p++)
+    {
+        candidateWeights[candidateAssignments.getCluster(p)] += 1.0;
+    }
+
+    // Recluster the candidates into k centers with weighted k-Means++.
+    auto candidatePoints = copyCandidates(candidates);
+    KMeansPlusPlusSeeder<T> seeder(candidatePoints, NumThreads);
+    seeder.setPointWeights(candidateWeights);
+    auto pickedCandidates = seeder.pickCenters(k, random);
+
+    std::vector<size_t> centers(k);
+    for (size_t c = 0; c < k; c++)
+    {
+        centers[c] = candidates[pickedCandidates[c]];
+    }
+    return centers;
+}
+
+template <typename T>
+void
+KMeansParallelInitialiser<T>::assignToCandidates(const std::vector<size_t> &candidates, ClusterAssignmentList &assignments)
+{
+    auto candidatePoints = copyCandidates(candidates);
+
+    utils::parallelFor(0, data.rows(), NumThreads, [&](size_t beginPoint, size_t endPoint)
+                       { assignClosestCentersBlocked(data, dataSquaredNorms, candidatePoints, assignments, beginPoint, endPoint); });
+}
+
+template <typename T>
+blaze::DynamicMatrix<T>
+KMeansParallelInitialiser<T>::copyCandidates(const std::vector<size_t> &candidates) const
+{
+    blaze::DynamicMatrix<T> candidatePoints(candidates.size(), data.columns());
+    for (size_t c = 0; c < candidates.size(); c++)
+    {
+        blaze::row(candidatePoints, c) = blaze::row(data, candidates[c]);
+    }
+    return candidatePoints;
+}
+
+template <typename T>
+void
+KMeansParallelInitialiser<T>::updateDistances(const std::vector<size_t> &newCandidates)
+{
+    if (newCandidates.empty())
+    {
+        return;
+    }
+
+    ClusterAssignmentList newAssignments(data.rows(), newCandidates.size());
+    assignToCandidates(newCandidates, newAssignments);
+
+    auto &distances = newAssignments.getCentroidDistances();
+    for (size_t p = 0; p < data.rows(); p++)
+    {
+        minSquaredDistances[p] = std::min(minSquaredDistances[p], distances[p] * distances[p]);
+    }
+
+    for (auto &&c : newCandidates)
+    {
+        minSquaredDistances[c] = 0.0;
+    }
+}
+
+template class clustering::KMeansParallelInitialiser<float>;
+template class clustering::KMeansParallelInitialiser<double>;
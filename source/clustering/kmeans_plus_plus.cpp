@@ -0,0 +1,205 @@
+#include <clustering/kmeans_plus_plus.hpp>
+
+using namespace clustering;
+
+namespace
+{
+    /**
+     * The number of points whose distances to a new center are computed at a time.
+     */
+    const size_t SeedingDistanceBatchSize = 256;
+
+    template <typename T>
+    double
+    calcSquaredPointDistance(const blaze::DynamicMatrix<T> &matrix, size_t p, size_t q)
+    {
+        return static_cast<double>(blaze::sqrNorm(blaze::row(matrix, p) - blaze::row(matrix, q)));
+    }
+
+    template <typename T>
+    double
+    calcSquaredPointDistance(const blaze::CompressedMatrix<T> &matrix, size_t p, size_t q)
+    {
+        return calcSquaredDistance(matrix, p, q);
+    }
+
+    template <typename T>
+    bool
+    calcSquaredPointDistancesSimd(const blaze::DynamicMatrix<T> &matrix, size_t q, size_t beginPoint, size_t endPoint, double *squaredDistances)
+    {
+        return calcSquaredDistancesSimd(matrix, q, beginPoint, endPoint, squaredDistances);
+    }
+
+    template <typename T>
+    bool
+    calcSquaredPointDistancesSimd(const blaze::CompressedMatrix<T> &/*matrix*/, size_t /*q*/, size_t /*beginPoint*/, size_t /*endPoint*/, double */*squaredDistances*/)
+    {
+        // Sparse distances only visit the nonzero entries and are not vectorised.
+        return false;
+    }
+}
+
+template <typename T, typename MatrixT>
+KMeansPlusPlusSeeder<T, MatrixT>::KMeansPlusPlusSeeder(const MatrixT &matrix, size_t numThreads, std::shared_ptr<PairwiseDistanceCache<T>> cache) : data(matrix), NumThreads(numThreads), distanceCache(cache), minSquaredDistances(matrix.rows()), minSquaredDistanceSampler(matrix.rows()), distanceChanged(matrix.rows())
+{
+    minSquaredDistances = std::numeric_limits<double>::max();
+}
+
+template <typename T, typename MatrixT>
+std::vector<size_t>
+KMeansPlusPlusSeeder<T, MatrixT>::pickCenters(size_t k, utils::Random &random)
+{
+    const size_t n = data.rows();
+    centers.reserve(centers.size() + k);
+
+    for (size_t c = 0; c < k; c++)
+    {
+        size_t centerIndex = 0;
+
+        if (centers.empty() && pointWeights.size() > 0)
+        {
+            // Pick the first centroid proportional to the weights.
+            centerIndex = random.choice(utils::WeightedSampler(pointWeights));
+        }
+        else if (centers.empty())
+        {
+            // Pick the first centroid uniformly at random.
+            auto randomPointGenerator = random.getIndexer(n);
+            centerIndex = randomPointGenerator.next();
+        }
+        else if (minSquaredDistanceSampler.getTotalWeight() > 0.0)
+        {
+            // Points that are far from all of the picked centers are more likely to be picked next.
+            centerIndex = random.choice(minSquaredDistanceSampler);
+        }
+        else
+        {
+            // Every point coincides with a center, so any point is as good as another.
+            auto randomPointGenerator = random.getIndexer(n);
+            centerIndex = randomPointGenerator.next();
+        }
+
+        KMEANS_LOG_DEBUG("Center index for %ld => %ld", c, centerIndex);
+        addCenter(centerIndex);
+    }
+
+    return centers;
+}
+
+template <typename T, typename MatrixT>
+void
+KMeansPlusPlusSeeder<T, MatrixT>::setPointWeights(const blaze::DynamicVector<double> &weights)
+{
+    assert(weights.size() == data.rows() && centers.empty());
+    pointWeights = weights;
+}
+
+template <typename T, typename MatrixT>
+void
+KMeansPlusPlusSeeder<T, MatrixT>::addCenter(size_t centerIndex)
+{
+    centers.push_back(centerIndex);
+
+    // Fetch the cached row once, the cache is not meant to be hit from every thread.
+    std::shared_ptr<CachedDistanceRow<T>> cachedDistances;
+    if (distanceCache != nullptr)
+    {
+        cachedDistances = std::make_shared<CachedDistanceRow<T>>(distanceCache->getRow(centerIndex));
+    }
+
+    utils::parallelFor(0, data.rows(), NumThreads, [&](size_t beginPoint, size_t endPoint)
+                       {
+                           if (cachedDistances != nullptr)
+                           {
+                               const auto &distances = *cachedDistances;
+                               for (size_t p = beginPoint; p < endPoint; p++)
+                               {
+                                   const double distance = static_cast<double>(distances[p]);
+                                   distanceChanged[p] = distance < minSquaredDistances[p];
+                                   minSquaredDistances[p] = std::min(minSquaredDistances[p], distance);
+                               }
+                               return;
+                           }
+
+                           // Distances are computed in small batches which stay in the cache.
+                           double distances[SeedingDistanceBatchSize];
+                           for (size_t batchBegin = beginPoint; batchBegin < endPoint; batchBegin += SeedingDistanceBatchSize)
+                           {
+                               const size_t batchEnd = std::min(endPoint, batchBegin + SeedingDistanceBatchSize);
+                               if (!calcSquaredPointDistancesSimd(data, centerIndex, batchBegin, batchEnd, distances))
+                               {
+                                   for (size_t p = batchBegin; p < batchEnd; p++)
+                                   {
+                                       distances[p - batchBegin] = calcSquaredPointDistance(data, p, centerIndex);
+                                   }
+                               }
+
+                               for (size_t p = batchBegin; p < batchEnd; p++)
+                               {
+                                   const double distance = distances[p - batchBegin];
+                                   distanceChanged[p] = distance < minSquaredDistances[p];
+                                   minSquaredDistances[p] = std::min(minSquaredDistances[p], distance);
+                               }
+                           }
+                       });
+
+    // Avoid rounding errors so a picked center is never picked again.
+    distanceChanged[centerIndex] = minSquaredDistances[centerIndex] != 0.0;
+    minSquaredDistances[centerIndex] = 0.0;
+
+    const size_t n = data.rows();
+    size_t numChanged = 0;
+    for (size_t p = 0; p < n; p++)
+    {
+        if (distanceChanged[p] != 0)
+        {
+            numChanged++;
+        }
+    }
+
+    // Each update costs O(log N) so rebuilding in O(N) is cheaper when most distances changed.
+    const bool isWeighted = pointWeights.size() > 0;
+    if (static_cast<double>(numChanged) * std::log2(static_cast<double>(n) + 1.0) > static_cast<double>(n))
+    {
+        if (isWeighted)
+        {
+            blaze::DynamicVector<double> samplingWeights(n);
+            for (size_t p = 0; p < n; p++)
+            {
+                samplingWeights[p] = pointWeights[p] * minSquaredDistances[p];
+            }
+            minSquaredDistanceSampler.rebuild(samplingWeights);
+            return;
+        }
+
+        minSquaredDistanceSampler.rebuild(minSquaredDistances);
+        return;
+    }
+
+    for (size_t p = 0; p < n; p++)
+    {
+        if (distanceChanged[p])
+        {
+            minSquaredDistanceSampler.update(p, isWeighted ? pointWeights[p] * minSquaredDistances[p] : minSquaredDistances[p]);
+        }
+    }
+}
+
+template <typename T, typename MatrixT>
+const blaze::DynamicVector<double> &
+KMeansPlusPlusSeeder<T, MatrixT>::getMinSquaredDistances() const
+{
+    return minSquaredDistances;
+}
+
+template <typename T, typename MatrixT>
+const std::vector<size_t> &
+KMeansPlusPlusSeeder<T, MatrixT>::getCenters() const
+{
+    return centers;
+}
+
+template class clustering::KMeansPlusPlusSeeder<float>;
+template class clustering::KMeansPlusPlusSeeder<double>;
+template class clustering::KMeansPlusPlusSeeder<float, blaze::CompressedMatrix<float>>;
+template class clustering::KMeansPlusPlusSeeder<double, blaze::CompressedMatrix<double>>;
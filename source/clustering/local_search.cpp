@@ -33,122 +33,362 @@ public:
 };
 
 
-LocalSearch::LocalSearch(uint k, uint s) : numOfClusters(k), swapSize(s)
+namespace
 {
+    /**
+     * Identify checkpoints written by `LocalSearch::run` and `LocalSearch::runPlusPlus`.
+     */
+    const char *const LocalSearchCheckpointName = "LocalSearch";
+    const char *const LocalSearchPlusPlusCheckpointName = "LocalSearch++";
+
+    /**
+     * Describes the data and the configuration of a search. A checkpoint is only resumed by a search with the same description.
+     */
+    template <typename T>
+    utils::Checkpoint
+    describeLocalSearch(const std::string &algorithm, const blaze::DynamicMatrix<T> &data, size_t k)
+    {
+        utils::Checkpoint description;
+        description.setText("Algorithm", algorithm);
+        description.setInteger("Points", data.rows());
+        description.setInteger("Dimensions", data.columns());
+        description.setInteger("DataFingerprint", utils::calcFingerprint(data));
+        description.setInteger("Clusters", k);
+        return description;
+    }
+
+    /**
+     * Returns the checkpoint to resume from, or null if there is none.
+     */
+    std::shared_ptr<utils::Checkpoint>
+    readLocalSearchCheckpoint(const std::string &filePath, const utils::Checkpoint &searchDescription)
+    {
+        auto checkpoint = utils::readCheckpoint(filePath);
+        if (checkpoint != nullptr && checkpoint->getText("Algorithm") != searchDescription.getText("Algorithm"))
+        {
+            throw std::invalid_argument("The checkpoint " + filePath + " was not written by " + searchDescription.getText("Algorithm") + ".");
+        }
+        if (checkpoint != nullptr && !checkpoint->includes(searchDescription))
+        {
+            throw std::invalid_argument("The checkpoint " + filePath + " was written by a search on other data or with another configuration.");
+        }
+        return checkpoint;
+    }
+
+    template <typename T>
+    blaze::DynamicMatrix<T>
+    restoreCenters(const utils::Checkpoint &checkpoint, const std::string &name, size_t k, size_t d)
+    {
+        auto centers = checkpoint.getMatrix(name);
+        if (centers.rows() != k || centers.columns() != d)
+        {
+            throw std::invalid_argument("The checkpoint does not match the number of clusters and the dimensions of the data.");
+        }
+        return blaze::DynamicMatrix<T>(centers);
+    }
+
+    std::vector<size_t>
+    toIndices(const blaze::DynamicVector<size_t> &vector)
+    {
+        return std::vector<size_t>(vector.begin(), vector.end());
+    }
+
+    blaze::DynamicVector<size_t>
+    toVector(const std::vector<size_t> &indices)
+    {
+        blaze::DynamicVector<size_t> vector(indices.size());
+        for (size_t i = 0; i < indices.size(); i++)
+        {
+            vector[i] = indices[i];
+        }
+        return vector;
+    }
 }
 
+LocalSearch::LocalSearch(uint k, uint s, bool useCache, size_t cacheBudget) : numOfClusters(k), swapSize(s), useDistanceCache(useCache), distanceCacheBudget(cacheBudget)
+{
+}
+
+template <typename T>
+void
+LocalSearch::assignPoints(ClusterAssignmentList &clusterAssignments, const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<T> &centers,
+                          const std::vector<size_t> &centerPoints, std::shared_ptr<PairwiseDistanceCache<T>> distanceCache)
+{
+    if (distanceCache != nullptr)
+    {
+        // Every center is a data point so the distances can be looked up.
+        clusterAssignments.assignAll(*distanceCache, centerPoints);
+        return;
+    }
+
+    clusterAssignments.assignAll(data, centers);
+}
+
+template <typename T>
 std::shared_ptr<ClusteringResult>
-LocalSearch::run(const blaze::DynamicMatrix<double> &data)
+LocalSearch::run(const blaze::DynamicMatrix<T> &data)
 {
     size_t n = data.rows();
     size_t k = this->numOfClusters;
 
-    // Initialise centers using  k-Means++.
-    KMeans kMeansAlg(k);
-    auto initialCenters = kMeansAlg.pickInitialCentersViaKMeansPlusPlus(data, false);
-    auto centers = kMeansAlg.copyRows(data, initialCenters);
-
-    // Assign points to clusters using initial centers generated by k-Means++ initialisation.
-    ClusterAssignmentList clusterAssignments(n, this->numOfClusters);
-    clusterAssignments.assignAll(data, centers);
+    // The same distance cache is used by the seeding and the swaps.
+    std::shared_ptr<PairwiseDistanceCache<T>> distanceCache;
+    if (this->useDistanceCache)
+    {
+        distanceCache = std::make_shared<PairwiseDistanceCache<T>>(data, this->distanceCacheBudget);
+    }
 
-    // Let the cost of the above clusterings be the best cost seen so far.
-    double bestCost = clusterAssignments.getTotalCost();
-    auto bestCenters = centers;
-    auto swapClusterAssignments = clusterAssignments;
-    auto bestClusterAssignments = swapClusterAssignments;
+    blaze::DynamicMatrix<T> centers;
+    std::vector<size_t> centerPoints;
+    ClusterAssignmentList swapClusterAssignments(n, this->numOfClusters);
+    ClusterAssignmentList bestClusterAssignments(n, this->numOfClusters);
+    blaze::DynamicMatrix<T> bestCenters;
+    double bestCost = 0.0;
+    size_t firstCluster = 0;
+
+    // Checkpoints are tied to the data and the configuration, so a checkpoint of another search is never resumed.
+    utils::Checkpoint searchDescription;
+    if (!this->checkpointPath.empty())
+    {
+        searchDescription = describeLocalSearch(LocalSearchCheckpointName, data, k);
+    }
 
-    printf("Cost before swaps %0.5f\n", bestCost);
+    auto checkpoint = readLocalSearchCheckpoint(this->checkpointPath, searchDescription);
+    if (checkpoint == nullptr)
+    {
+        // Initialise centers using  k-Means++.
+        KMeans kMeansAlg(k);
+        auto initialCenters = kMeansAlg.pickInitialCentersViaKMeansPlusPlus(data, distanceCache);
+        centers = kMeansAlg.copyRows(data, initialCenters);
+        centerPoints = initialCenters;
+
+        // Assign points to clusters using initial centers generated by k-Means++ initialisation.
+        ClusterAssignmentList clusterAssignments(n, this->numOfClusters);
+        assignPoints(clusterAssignments, data, centers, centerPoints, distanceCache);
+
+        // Let the cost of the above clusterings be the best cost seen so far.
+        bestCost = clusterAssignments.getTotalCost();
+        bestCenters = centers;
+        swapClusterAssignments = clusterAssignments;
+        bestClusterAssignments = swapClusterAssignments;
+
+        KMEANS_LOG_INFO("Cost before swaps %0.5f", bestCost);
+        KMEANS_LOG_DEBUG("Best centers:\n%s", utils::toString(bestCenters).c_str());
+    }
+    else
+    {
+        firstCluster = checkpoint->getInteger("Cluster");
+        centers = restoreCenters<T>(*checkpoint, "Centers", k, data.columns());
+        centerPoints = checkpoint->getIndices("CenterPoints");
+        bestCost = checkpoint->getReal("BestCost");
+        bestCenters = restoreCenters<T>(*checkpoint, "BestCenters", k, data.columns());
+        bestClusterAssignments.loadFrom(*checkpoint, "BestAssignments");
+
+        KMEANS_LOG_INFO("Resuming local search from the checkpoint at cluster %ld with cost %0.5f", firstCluster, bestCost);
+    }
 
-    std::cout << "Best centers: \n"
-              << bestCenters << "\n";
+    // Snapshots are taken between clusters and written on a background thread.
+    std::unique_ptr<utils::CheckpointWriter> checkpointWriter;
+    if (!this->checkpointPath.empty())
+    {
+        checkpointWriter = std::make_unique<utils::CheckpointWriter>(this->checkpointPath);
+    }
 
-    for (size_t c = 0; c < k; c++)
+    for (size_t c = firstCluster; c < k; c++)
     {
         for (size_t p = 0; p < n; p++)
         {
             // Swap one center (c) with a point (p)
             blaze::row(centers, c) = blaze::row(data, p);
+            centerPoints[c] = p;
 
             // Reassign points to potentially new centers after the swap.
-            swapClusterAssignments.assignAll(data, centers);
+            assignPoints(swapClusterAssignments, data, centers, centerPoints, distanceCache);
 
             // The cost after the swap.
             double cost = swapClusterAssignments.getTotalCost();
 
-            printf("Swaping cluster %3ld with point %3ld result in cost %0.5f\n", c, p, cost);
+            KMEANS_LOG_TRACE("Swaping cluster %3ld with point %3ld result in cost %0.5f", c, p, cost);
 
             if (cost < bestCost)
             {
                 bestCost = cost;
                 bestCenters = centers;
                 bestClusterAssignments = swapClusterAssignments;
-                std::cout << "Found new best centers: \n"
-                          << bestCenters << "\n";
+                KMEANS_LOG_DEBUG("Found new best centers:\n%s", utils::toString(bestCenters).c_str());
             }
         }
+
+        if (checkpointWriter != nullptr && (c + 1) % this->checkpointInterval == 0 && c + 1 < k)
+        {
+            auto snapshot = std::make_shared<utils::Checkpoint>();
+            snapshot->setAll(searchDescription);
+            snapshot->setInteger("Cluster", c + 1);
+            snapshot->setMatrix("Centers", blaze::DynamicMatrix<double>(centers));
+            snapshot->setIndices("CenterPoints", centerPoints);
+            snapshot->setReal("BestCost", bestCost);
+            snapshot->setMatrix("BestCenters", blaze::DynamicMatrix<double>(bestCenters));
+            bestClusterAssignments.saveTo(*snapshot, "BestAssignments");
+            checkpointWriter->write(snapshot);
+        }
     }
 
-    return std::make_shared<ClusteringResult>(bestClusterAssignments, bestCenters);
+    if (checkpointWriter != nullptr)
+    {
+        // The next search with the same path starts from scratch.
+        checkpointWriter->remove();
+    }
+
+    blaze::DynamicMatrix<double> finalCenters(bestCenters);
+    return std::make_shared<ClusteringResult>(bestClusterAssignments, finalCenters);
 }
 
+template <typename T>
 std::shared_ptr<ClusteringResult>
-LocalSearch::runPlusPlus(const blaze::DynamicMatrix<double> &data, size_t nSamples, size_t nIterations)
+LocalSearch::runPlusPlus(const blaze::DynamicMatrix<T> &data, size_t nSamples, size_t nIterations)
 {
     utils::Random random;
     size_t n = data.rows();
     size_t k = this->numOfClusters;
 
-    // Initialise centers using  k-Means++.
-    KMeans kMeansAlg(k);
-    auto initialCenters = kMeansAlg.pickInitialCentersViaKMeansPlusPlus(data, false);
-    auto centers = kMeansAlg.copyRows(data, initialCenters);
+    // The same distance cache is used by the seeding and the swaps.
+    std::shared_ptr<PairwiseDistanceCache<T>> distanceCache;
+    if (this->useDistanceCache)
+    {
+        distanceCache = std::make_shared<PairwiseDistanceCache<T>>(data, this->distanceCacheBudget);
+    }
 
-    // Assign points to clusters using initial centers generated by k-Means++ initialisation.
+    blaze::DynamicMatrix<T> centers;
+    std::vector<size_t> centerPoints;
     ClusterAssignmentList clusterAssignments(n, this->numOfClusters);
-    clusterAssignments.assignAll(data, centers);
-
-    // Let the cost of the above clusterings be the best cost seen so far.
-    auto bestCost = clusterAssignments.getTotalCost();
-    auto bestCenters = centers;
-    auto bestClusterAssignments = clusterAssignments;
-
-    printf("Intial cost: %0.5f\n", bestCost);
-    std::cout << "Initial centers \n"
-              << bestCenters << "\n";
+    ClusterAssignmentList bestClusterAssignments(n, this->numOfClusters);
+    blaze::DynamicMatrix<T> bestCenters;
+    double bestCost = 0.0;
 
     blaze::DynamicVector<size_t> bestPointsUsedAsCenters(k);
     blaze::DynamicVector<size_t> pointsUsedAsCenters(k);
     size_t swapCount = 0;
+    size_t firstIteration = 0;
+
+    // Checkpoints are tied to the data and the configuration, so a checkpoint of another search is never resumed.
+    utils::Checkpoint searchDescription;
+    if (!this->checkpointPath.empty())
+    {
+        searchDescription = describeLocalSearch(LocalSearchPlusPlusCheckpointName, data, k);
+        searchDescription.setInteger("Samples", nSamples);
+        searchDescription.setInteger("Iterations", nIterations);
+    }
+
+    auto checkpoint = readLocalSearchCheckpoint(this->checkpointPath, searchDescription);
+    if (checkpoint == nullptr)
+    {
+        // Initialise centers using  k-Means++.
+        KMeans kMeansAlg(k);
+        auto initialCenters = kMeansAlg.pickInitialCentersViaKMeansPlusPlus(data, distanceCache);
+        centers = kMeansAlg.copyRows(data, initialCenters);
+        centerPoints = initialCenters;
+
+        // Assign points to clusters using initial centers generated by k-Means++ initialisation.
+        assignPoints(clusterAssignments, data, centers, centerPoints, distanceCache);
+
+        // Let the cost of the above clusterings be the best cost seen so far.
+        bestCost = clusterAssignments.getTotalCost();
+        bestCenters = centers;
+        bestClusterAssignments = clusterAssignments;
+
+        KMEANS_LOG_INFO("Intial cost: %0.5f", bestCost);
+        KMEANS_LOG_DEBUG("Initial centers\n%s", utils::toString(bestCenters).c_str());
+    }
+    else
+    {
+        firstIteration = checkpoint->getInteger("Iteration");
+        centers = restoreCenters<T>(*checkpoint, "Centers", k, data.columns());
+        centerPoints = checkpoint->getIndices("CenterPoints");
+        clusterAssignments.loadFrom(*checkpoint, "Assignments");
+        bestCost = checkpoint->getReal("BestCost");
+        bestCenters = restoreCenters<T>(*checkpoint, "BestCenters", k, data.columns());
+        bestClusterAssignments.loadFrom(*checkpoint, "BestAssignments");
+        bestPointsUsedAsCenters = toVector(checkpoint->getIndices("BestPointsUsedAsCenters"));
+        pointsUsedAsCenters = toVector(checkpoint->getIndices("PointsUsedAsCenters"));
+        swapCount = checkpoint->getInteger("SwapCount");
+        random.setState(checkpoint->getText("RandomState"));
+
+        KMEANS_LOG_INFO("Resuming local search from the checkpoint at iteration %ld with cost %0.5f", firstIteration, bestCost);
+    }
+
+    // Sum-tree over the costs so only the costs that changed are updated between iterations.
+    utils::WeightedSampler costSampler(clusterAssignments.getCentroidDistances());
+
+    // Snapshots are taken between iterations and written on a background thread.
+    std::unique_ptr<utils::CheckpointWriter> checkpointWriter;
+    if (!this->checkpointPath.empty())
+    {
+        checkpointWriter = std::make_unique<utils::CheckpointWriter>(this->checkpointPath);
+    }
+
+    size_t numStartedIterations = 0;
+    auto saveCheckpoint = [&](size_t iteration)
+    {
+        auto snapshot = std::make_shared<utils::Checkpoint>();
+        snapshot->setAll(searchDescription);
+        snapshot->setInteger("Iteration", iteration);
+        snapshot->setMatrix("Centers", blaze::DynamicMatrix<double>(centers));
+        snapshot->setIndices("CenterPoints", centerPoints);
+        clusterAssignments.saveTo(*snapshot, "Assignments");
+        snapshot->setReal("BestCost", bestCost);
+        snapshot->setMatrix("BestCenters", blaze::DynamicMatrix<double>(bestCenters));
+        bestClusterAssignments.saveTo(*snapshot, "BestAssignments");
+        snapshot->setIndices("BestPointsUsedAsCenters", toIndices(bestPointsUsedAsCenters));
+        snapshot->setIndices("PointsUsedAsCenters", toIndices(pointsUsedAsCenters));
+        snapshot->setInteger("SwapCount", swapCount);
+        snapshot->setText("RandomState", random.getState());
+        checkpointWriter->write(snapshot);
+    };
 
 resetIteration:
-    for (size_t iteration = 0; iteration < nIterations; iteration++)
+    for (size_t iteration = firstIteration; iteration < nIterations; iteration++)
     {
-        // printf("Starting iteration %ld\n\n", iteration);
+        KMEANS_LOG_TRACE("Starting iteration %ld", iteration);
 
-        auto costs = clusterAssignments.getCentroidDistances();
-        auto sampledPoints = random.choice(nSamples, n, costs); // TODO: Without replacement?
+        if (checkpointWriter != nullptr && numStartedIterations++ % this->checkpointInterval == 0)
+        {
+            saveCheckpoint(iteration);
+        }
 
-        // std::cout << "Sampled points: \n" << *sampledPoints << "\n";
+        auto &costs = clusterAssignments.getCentroidDistances();
+        for (size_t p = 0; p < n; p++)
+        {
+            if (costs[p] != costSampler.getWeight(p))
+            {
+                costSampler.update(p, costs[p]);
+            }
+        }
+
+        std::vector<size_t> sampledPoints(nSamples); // TODO: Without replacement?
+        for (size_t s = 0; s < nSamples; s++)
+        {
+            sampledPoints[s] = random.choice(costSampler);
+        }
 
         for (size_t c = 0; c < k; c++)
         {
-            for (auto &&p : *sampledPoints)
+            for (auto &&p : sampledPoints)
             {
                 // Swap one center (c) with a point (p)
                 blaze::row(centers, c) = blaze::row(data, p);
+                centerPoints[c] = p;
 
                 swapCount++;
 
                 pointsUsedAsCenters[c] = p;
 
                 // Reassign points to potentially new centers after the swap.
-                clusterAssignments.assignAll(data, centers);
+                assignPoints(clusterAssignments, data, centers, centerPoints, distanceCache);
 
                 // The cost after the swap.
                 double cost = clusterAssignments.getTotalCost();
 
-                // printf("Swaping cluster %3ld with point %3ld costs %0.5f\n", c, p, cost);
+                KMEANS_LOG_TRACE("Swaping cluster %3ld with point %3ld costs %0.5f", c, p, cost);
 
                 if (cost < bestCost)
                 {
@@ -157,16 +397,34 @@ resetIteration:
                     bestCost = cost;
                     bestCenters = centers;
                     bestClusterAssignments = clusterAssignments;
-                    printf("Found new best cost: %0.5f - number of swaps performed %ld  - ", bestCost, swapCount);
-                    std::cout << "New best centers: \n" << bestCenters << "\n";
+                    KMEANS_LOG_DEBUG("Found new best cost: %0.5f - number of swaps performed %ld - New best centers:\n%s", bestCost, swapCount, utils::toString(bestCenters).c_str());
+                    firstIteration = 0;
                     goto resetIteration;
                 }
             }
         }
     }
 
-    std::cout << "Final points used as centers: \n"
-              << bestPointsUsedAsCenters << "\n\n";
+    if (checkpointWriter != nullptr)
+    {
+        // The next search with the same path starts from scratch.
+        checkpointWriter->remove();
+    }
+
+    KMEANS_LOG_INFO("Final points used as centers:\n%s", utils::toString(bestPointsUsedAsCenters).c_str());
 
-    return std::make_shared<ClusteringResult>(bestClusterAssignments, bestCenters);
+    blaze::DynamicMatrix<double> finalCenters(bestCenters);
+    return std::make_shared<ClusteringResult>(bestClusterAssignments, finalCenters);
 }
+
+void
+LocalSearch::enableCheckpoints(const std::string &filePath, size_t interval)
+{
+    this->checkpointPath = filePath;
+    this->checkpointInterval = std::max<size_t>(1, interval);
+}
+
+template std::shared_ptr<ClusteringResult> LocalSearch::run(const blaze::DynamicMatrix<float> &);
+template std::shared_ptr<ClusteringResult> LocalSearch::run(const blaze::DynamicMatrix<double> &);
+template std::shared_ptr<ClusteringResult> LocalSearch::runPlusPlus(const blaze::DynamicMatrix<float> &, size_t, size_t);
+template std::shared_ptr<ClusteringResult> LocalSearch::runPlusPlus(const blaze::DynamicMatrix<double> &, size_t, size_t);
@@ -0,0 +1,96 @@
+#include <clustering/mini_batch_kmeans.hpp>
+
+using namespace clustering;
+
+MiniBatchKMeans::MiniBatchKMeans(uint k, size_t b, uint miter, double convDiff) : NumOfClusters(k), BatchSize(b), MaxIterations(miter), ConvergenceDiff(convDiff)
+{
+}
+
+template <typename T>
+std::shared_ptr<ClusteringResult>
+MiniBatchKMeans::run(const blaze::DynamicMatrix<T> &data)
+{
+    const size_t n = data.rows();
+    const size_t k = this->NumOfClusters;
+
+    if (n < k)
+    {
+        throw std::invalid_argument("The data has fewer rows than the number of clusters.");
+    }
+
+    // Notice that the indexer keeps its own random engine, so the same indexer must be
+    // reused for all batches otherwise every batch would contain the same points.
+    auto pointSampler = random.getIndexer(n);
+
+    auto centers = pickInitialCenters(data, pointSampler);
+
+    // The number of points assigned to each center so far: v(c)
+    blaze::DynamicVector<size_t> centerCounts(k);
+    centerCounts.reset();
+
+    ClusterAssignmentList batchAssignments(BatchSize, k);
+
+    for (size_t i = 0; i < this->MaxIterations; i++)
+    {
+        auto batch = sampleRows(data, BatchSize, pointSampler);
+
+        // Cache the closest center of each point in the batch before moving any center.
+        batchAssignments.assignAll(batch, centers);
+
+        blaze::DynamicMatrix<T> oldCenters(centers);
+
+        for (size_t p = 0; p < BatchSize; p++)
+        {
+            const size_t c = batchAssignments.getCluster(p);
+            centerCounts[c] += 1;
+
+            // Per-center learning rate: η = 1 / v(c)
+            const T learningRate = T(1) / static_cast<T>(centerCounts[c]);
+
+            // c = (1 - η)c + ηx
+            blaze::row(centers, c) = (T(1) - learningRate) * blaze::row(centers, c) + learningRate * blaze::row(batch, p);
+        }
+
+        auto frobeniusNormDiff = blaze::norm(centers - oldCenters);
+        if (static_cast<double>(frobeniusNormDiff) < this->ConvergenceDiff)
+        {
+            KMEANS_LOG_DEBUG("Stopping mini-batch k-Means after %ld iterations. Frobenius norm diff: %0.5f", i + 1, static_cast<double>(frobeniusNormDiff));
+            break;
+        }
+    }
+
+    // Only a single pass over the full dataset is needed to assign all points.
+    ClusterAssignmentList clusterAssignments(n, k);
+    clusterAssignments.assignAll(data, centers);
+
+    blaze::DynamicMatrix<double> finalCenters(centers);
+    return std::make_shared<ClusteringResult>(clusterAssignments, finalCenters);
+}
+
+template <typename T>
+blaze::DynamicMatrix<T>
+MiniBatchKMeans::pickInitialCenters(const blaze::DynamicMatrix<T> &data, utils::RandomIndexer &pointSampler)
+{
+    // Seed on a few batches worth of points so the seeding does not scale with N either.
+    const size_t initialSampleSize = std::max(3 * BatchSize, 3 * NumOfClusters);
+    auto sample = sampleRows(data, initialSampleSize, pointSampler);
+
+    KMeans kMeansAlg(static_cast<uint>(NumOfClusters));
+    auto initialCenters = kMeansAlg.pickInitialCentersViaKMeansPlusPlus(sample, false);
+    return kMeansAlg.copyRows(sample, initialCenters);
+}
+
+template <typename T>
+blaze::DynamicMatrix<T>
+MiniBatchKMeans::sampleRows(const blaze::DynamicMatrix<T> &data, size_t numOfSamples, utils::RandomIndexer &pointSampler)
+{
+    blaze::DynamicMatrix<T> samples(numOfSamples, data.columns());
+    for (size_t i = 0; i < numOfSamples; i++)
+    {
+        blaze::row(samples, i) = blaze::row(data, pointSampler.next());
+    }
+    return samples;
+}
+
+template std::shared_ptr<ClusteringResult> MiniBatchKMeans::run(const blaze::DynamicMatrix<float> &);
+template std::shared_ptr<ClusteringResult> MiniBatchKMeans::run(const blaze::DynamicMatrix<double> &);
@@ -0,0 +1,224 @@
+#include <clustering/out_of_core_kmeans.hpp>
+
+using namespace clustering;
+
+OutOfCoreKMeans::OutOfCoreKMeans(uint k, size_t blockRows, uint miter, double convDiff, uint numThreads) : NumOfClusters(k), BlockRows(std::max<size_t>(1, blockRows)), MaxIterations(miter), ConvergenceDiff(convDiff), NumThreads(numThreads)
+{
+}
+
+template <typename T, typename AccumulatorT>
+std::shared_ptr<ClusteringResult>
+OutOfCoreKMeans::run(data::BlockFileReader<T> &reader)
+{
+    const size_t n = reader.getNumberOfRows();
+    const size_t d = reader.getNumberOfColumns();
+    const size_t k = this->NumOfClusters;
+    const size_t numThreads = utils::resolveNumberOfThreads(this->NumThreads);
+
+    if (n < k)
+    {
+        throw std::invalid_argument("The block file has fewer rows than the number of clusters.");
+    }
+
+    auto centroids = pickInitialCenters(reader);
+
+    // Sums are accumulated per block in partitions which only depend on the number of rows in the block, K and D.
+    // Only as many partition sums are allocated as the largest block uses.
+    std::vector<blaze::DynamicMatrix<AccumulatorT>> partitionSums;
+    std::vector<blaze::DynamicVector<size_t>> partitionCounts;
+    blaze::DynamicMatrix<AccumulatorT> centroidSums(k, d);
+    blaze::DynamicVector<size_t> clusterMemberCounts(k);
+
+    // Only the assignments of one block are stored in full, the cluster of every point is kept as a label.
+    ClusterAssignmentList blockAssignments(std::min(BlockRows, n), k);
+    std::vector<uint32_t> labels(n, UINT32_MAX);
+
+    for (size_t i = 0; i < this->MaxIterations; i++)
+    {
+        centroidSums = 0;
+        clusterMemberCounts = 0;
+        size_t numOfChangedLabels = 0;
+
+        forEachBlock<T>(reader, [&](size_t firstRow, const blaze::DynamicMatrix<T> &block)
+                        {
+                            const size_t rows = block.rows();
+                            assignBlock(block, centroids, blockAssignments, numThreads);
+
+                            const size_t numPartitions = getNumberOfAccumulatorPartitions(rows, k * d * sizeof(AccumulatorT));
+                            if (partitionSums.size() < numPartitions)
+                            {
+                                partitionSums.resize(numPartitions);
+                                partitionCounts.resize(numPartitions);
+                            }
+                            utils::parallelForPartitions(0, rows, numPartitions, numThreads, [&](size_t partition, size_t beginPoint, size_t endPoint)
+                                                         {
+                                                             auto &sums = partitionSums[partition];
+                                                             auto &counts = partitionCounts[partition];
+                                                             sums.resize(k, d, false);
+                                                             counts.resize(k, false);
+                                                             sums = 0;
+                                                             counts = 0;
+
+                                                             for (size_t p = beginPoint; p < endPoint; p++)
+                                                             {
+                                                                 const size_t c = blockAssignments.getCluster(p);
+                                                                 blaze::row(sums, c) += blaze::row(block, p);
+                                                                 counts[c] += 1;
+                                                             }
+                                                         });
+
+                            for (size_t partition = 0; partition < numPartitions; partition++)
+                            {
+                                centroidSums += partitionSums[partition];
+                                clusterMemberCounts += partitionCounts[partition];
+                            }
+
+                            for (size_t p = 0; p < rows; p++)
+                            {
+                                const auto c = static_cast<uint32_t>(blockAssignments.getCluster(p));
+                                if (labels[firstRow + p] != c)
+                                {
+                                    labels[firstRow + p] = c;
+                                    numOfChangedLabels++;
+                                }
+                            }
+                        });
+
+        KMEANS_LOG_DEBUG("%ld points changed their cluster in iteration %ld", numOfChangedLabels, i);
+
+        // When no point changed its cluster, the centroids are the same as in the previous iteration.
+        if (numOfChangedLabels == 0)
+        {
+            KMEANS_LOG_INFO("Stopping k-Means as no point changed its cluster.");
+            break;
+        }
+
+        blaze::DynamicMatrix<T> oldCentroids(centroids);
+
+        for (size_t c = 0; c < k; c++)
+        {
+            const auto count = std::max<size_t>(1, clusterMemberCounts[c]);
+            blaze::row(centroidSums, c) /= static_cast<AccumulatorT>(count);
+        }
+
+        // Round the means to the precision of the data only after they are computed.
+        centroids = centroidSums;
+
+        auto frobeniusNormDiff = blaze::norm(centroids - oldCentroids);
+        KMEANS_LOG_DEBUG("Frobenius norm of centroids difference after iteration %ld: %g", i, static_cast<double>(frobeniusNormDiff));
+
+        if (static_cast<double>(frobeniusNormDiff) < this->ConvergenceDiff)
+        {
+            KMEANS_LOG_INFO("Stopping k-Means as centroids do not improve. Frobenius norm Diff: %g", static_cast<double>(frobeniusNormDiff));
+            break;
+        }
+    }
+
+    // The assignments and costs are computed against the final centroids in one more pass.
+    ClusterAssignmentList clusterAssignments(n, k);
+    forEachBlock<T>(reader, [&](size_t firstRow, const blaze::DynamicMatrix<T> &block)
+                    {
+                        assignBlock(block, centroids, blockAssignments, numThreads);
+                        for (size_t p = 0; p < block.rows(); p++)
+                        {
+                            clusterAssignments.assign(firstRow + p, blockAssignments.getCluster(p), blockAssignments.getPointCost(p));
+                        }
+                    });
+
+    blaze::DynamicMatrix<double> finalCentroids(centroids);
+    return std::make_shared<ClusteringResult>(clusterAssignments, finalCentroids);
+}
+
+template <typename T>
+blaze::DynamicMatrix<T>
+OutOfCoreKMeans::pickInitialCenters(data::BlockFileReader<T> &reader)
+{
+    const size_t n = reader.getNumberOfRows();
+    const size_t sampleSize = std::max(BlockRows, NumOfClusters);
+
+    blaze::DynamicMatrix<T> sample;
+    if (n <= sampleSize)
+    {
+        reader.readRows(0, n, sample);
+    }
+    else
+    {
+        // Read the sampled rows in file order so the reads move forward through the file.
+        auto pointSampler = random.getIndexer(n);
+        std::vector<size_t> sampledRows(sampleSize);
+        for (size_t i = 0; i < sampleSize; i++)
+        {
+            sampledRows[i] = pointSampler.next();
+        }
+        std::sort(sampledRows.begin(), sampledRows.end());
+
+        sample.resize(sampleSize, reader.getNumberOfColumns(), false);
+        blaze::DynamicMatrix<T> row;
+        for (size_t i = 0; i < sampleSize; i++)
+        {
+            reader.readRows(sampledRows[i], 1, row);
+            blaze::row(sample, i) = blaze::row(row, 0);
+        }
+    }
+
+    KMeans kMeansAlg(static_cast<uint>(NumOfClusters));
+    auto initialCenters = kMeansAlg.pickInitialCentersViaKMeansPlusPlus(sample, false);
+    return kMeansAlg.copyRows(sample, initialCenters);
+}
+
+template <typename T>
+void
+OutOfCoreKMeans::forEachBlock(data::BlockFileReader<T> &reader, const std::function<void(size_t, const blaze::DynamicMatrix<T> &)> &processBlock)
+{
+    const size_t n = reader.getNumberOfRows();
+
+    blaze::DynamicMatrix<T> currentBlock;
+    blaze::DynamicMatrix<T> nextBlock;
+    reader.readRows(0, std::min(BlockRows, n), currentBlock);
+
+    for (size_t firstRow = 0; firstRow < n; firstRow += BlockRows)
+    {
+        // The reader is only used by the prefetching thread until the future is waited for.
+        const size_t nextRow = firstRow + BlockRows;
+        std::future<void> prefetch;
+        if (nextRow < n)
+        {
+            prefetch = std::async(std::launch::async, [&reader, &nextBlock, nextRow, n, this]
+                                  { reader.readRows(nextRow, std::min(BlockRows, n - nextRow), nextBlock); });
+        }
+
+        processBlock(firstRow, currentBlock);
+
+        if (prefetch.valid())
+        {
+            prefetch.get();
+            std::swap(currentBlock, nextBlock);
+        }
+    }
+}
+
+template <typename T>
+void
+OutOfCoreKMeans::assignBlock(const blaze::DynamicMatrix<T> &block, const blaze::DynamicMatrix<T> &centroids, ClusterAssignmentList &assignments, size_t numThreads)
+{
+    if (isSimdAssignmentSupported<T>(block.columns(), centroids.rows()))
+    {
+        utils::parallelFor(0, block.rows(), numThreads, [&](size_t beginPoint, size_t endPoint)
+                           { assignClosestCentersSimd(block, centroids, assignments, beginPoint, endPoint); });
+    }
+    else if (isFixedDimensionSupported(block.columns()))
+    {
+        utils::parallelFor(0, block.rows(), numThreads, [&](size_t beginPoint, size_t endPoint)
+                           { assignClosestCentersFixedDimension(block, centroids, assignments, beginPoint, endPoint); });
+    }
+    else
+    {
+        const auto squaredNorms = calcSquaredRowNorms(block);
+        utils::parallelFor(0, block.rows(), numThreads, [&](size_t beginPoint, size_t endPoint)
+                           { assignClosestCentersBlocked(block, squaredNorms, centroids, assignments, beginPoint, endPoint); });
+    }
+}
+
+template std::shared_ptr<ClusteringResult> OutOfCoreKMeans::run<float, float>(data::BlockFileReader<float> &);
+template std::shared_ptr<ClusteringResult> OutOfCoreKMeans::run<float, double>(data::BlockFileReader<float> &);
+template std::shared_ptr<ClusteringResult> OutOfCoreKMeans::run<double, double>(data::BlockFileReader<double> &);
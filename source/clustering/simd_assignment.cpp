@@ -0,0 +1,442 @@
+#include <clustering/simd_assignment.hpp>
+
+using namespace clustering;
+
+// The kernels are compiled for each instruction set with target attributes, so no file needs
+// special compiler flags and the binary still runs on CPUs without the wider vectors.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define KMEANS_SIMD_DISPATCH 1
+#endif
+
+#if defined(__clang__)
+#define KMEANS_SIMD_TARGET(isa) __attribute__((target(isa)))
+#else
+// Fused multiply-adds would round differently on each instruction set.
+#define KMEANS_SIMD_TARGET(isa) __attribute__((target(isa), optimize("fp-contract=off")))
+#endif
+
+#define KMEANS_SIMD_INLINE inline __attribute__((always_inline))
+
+namespace
+{
+    /**
+     * The active instruction set, negative until it is detected or set.
+     */
+    std::atomic<int> activeSimdLevel(-1);
+
+    /**
+     * The size of the widest vector in bytes.
+     */
+    const size_t MaxVectorBytes = 64;
+
+#ifdef KMEANS_SIMD_DISPATCH
+    /**
+     * @brief Centers stored dimension by dimension, so that Values[j * PaddedCenters + c] is dimension j of center c.
+     */
+    template <typename T>
+    struct PackedCenters
+    {
+        size_t NumOfCenters;
+        size_t PaddedCenters;
+        size_t NumOfDimensions;
+        std::vector<T> Values;
+    };
+
+    template <typename T>
+    PackedCenters<T>
+    packCenters(const blaze::DynamicMatrix<T> &centers)
+    {
+        const size_t k = centers.rows();
+        const size_t d = centers.columns();
+        const size_t lanes = MaxVectorBytes / sizeof(T);
+
+        PackedCenters<T> packed;
+        packed.NumOfCenters = k;
+        packed.PaddedCenters = (k + lanes - 1) / lanes * lanes;
+        packed.NumOfDimensions = d;
+
+        // Padding centers are infinitely far away so they are never the closest center.
+        packed.Values.assign(packed.PaddedCenters * d, std::numeric_limits<T>::infinity());
+        for (size_t c = 0; c < k; c++)
+        {
+            for (size_t j = 0; j < d; j++)
+            {
+                packed.Values[j * packed.PaddedCenters + c] = centers(c, j);
+            }
+        }
+        return packed;
+    }
+
+    /**
+     * @brief Vectors of `Bytes` bytes with lanes of type `T` and integer lanes of the same size.
+     */
+    template <typename T, size_t Bytes>
+    struct SimdVector
+    {
+        typedef T Vector __attribute__((vector_size(Bytes)));
+
+        typedef typename std::conditional<sizeof(T) == 4, int32_t, int64_t>::type Index;
+
+        typedef Index IndexVector __attribute__((vector_size(Bytes)));
+
+        static constexpr size_t Width = Bytes / sizeof(T);
+    };
+
+    /**
+     * @brief Updates the closest center of each lane with `NumVectors` consecutive vectors of centers.
+     *
+     * Each coordinate of the point is broadcast once and reused for all vectors of centers, whose
+     * distances are accumulated in registers.
+     */
+    template <typename T, size_t Bytes, size_t NumVectors>
+    KMEANS_SIMD_INLINE void
+    updateClosestCenters(const T *point, const PackedCenters<T> &centers, size_t firstVector,
+                         const typename SimdVector<T, Bytes>::IndexVector &laneIndices,
+                         typename SimdVector<T, Bytes>::Vector &bestDistances,
+                         typename SimdVector<T, Bytes>::IndexVector &bestClusters)
+    {
+        using Vector = typename SimdVector<T, Bytes>::Vector;
+        using Index = typename SimdVector<T, Bytes>::Index;
+        constexpr size_t Width = SimdVector<T, Bytes>::Width;
+
+        Vector distances[NumVectors];
+        for (size_t v = 0; v < NumVectors; v++)
+        {
+            distances[v] = Vector{};
+        }
+
+        const T *values = centers.Values.data() + firstVector * Width;
+        for (size_t j = 0; j < centers.NumOfDimensions; j++, values += centers.PaddedCenters)
+        {
+            const Vector coordinate = Vector{} + point[j];
+            for (size_t v = 0; v < NumVectors; v++)
+            {
+                Vector center;
+                std::memcpy(&center, values + v * Width, sizeof(center));
+
+                // Separate statements so the distances are summed like the scalar kernels.
+                const Vector diff = center - coordinate;
+                const Vector squaredDiff = diff * diff;
+                distances[v] += squaredDiff;
+            }
+        }
+
+        for (size_t v = 0; v < NumVectors; v++)
+        {
+            const auto isCloser = distances[v] < bestDistances;
+            bestDistances = isCloser ? distances[v] : bestDistances;
+            bestClusters = isCloser ? laneIndices + static_cast<Index>((firstVector + v) * Width) : bestClusters;
+        }
+    }
+
+    /**
+     * @brief Visits the remaining vectors of centers in groups of `NumVectors`, then in smaller groups.
+     */
+    template <typename T, size_t Bytes, size_t NumVectors>
+    KMEANS_SIMD_INLINE void
+    updateClosestCentersInGroups(const T *point, const PackedCenters<T> &centers, size_t &nextVector, size_t numOfVectors,
+                                 const typename SimdVector<T, Bytes>::IndexVector &laneIndices,
+                                 typename SimdVector<T, Bytes>::Vector &bestDistances,
+                                 typename SimdVector<T, Bytes>::IndexVector &bestClusters)
+    {
+        for (; nextVector + NumVectors <= numOfVectors; nextVector += NumVectors)
+        {
+            updateClosestCenters<T, Bytes, NumVectors>(point, centers, nextVector, laneIndices, bestDistances, bestClusters);
+        }
+
+        if constexpr (NumVectors > 1)
+        {
+            updateClosestCentersInGroups<T, Bytes, NumVectors / 2>(point, centers, nextVector, numOfVectors, laneIndices, bestDistances, bestClusters);
+        }
+    }
+
+    template <typename T, size_t Bytes, size_t MaxVectors>
+    KMEANS_SIMD_INLINE void
+    assignClosestCentersVectorised(const blaze::DynamicMatrix<T> &data, const PackedCenters<T> &centers,
+                                   ClusterAssignmentList &assignments, size_t beginPoint, size_t endPoint)
+    {
+        using Vector = typename SimdVector<T, Bytes>::Vector;
+        using Index = typename SimdVector<T, Bytes>::Index;
+        using IndexVector = typename SimdVector<T, Bytes>::IndexVector;
+        constexpr size_t Width = SimdVector<T, Bytes>::Width;
+
+        Index lanes[Width];
+        for (size_t l = 0; l < Width; l++)
+        {
+            lanes[l] = static_cast<Index>(l);
+        }
+        IndexVector laneIndices;
+        std::memcpy(&laneIndices, lanes, sizeof(laneIndices));
+
+        const size_t numOfVectors = (centers.NumOfCenters + Width - 1) / Width;
+
+        for (size_t p = beginPoint; p < endPoint; p++)
+        {
+            Vector bestDistances = Vector{} + std::numeric_limits<T>::max();
+            IndexVector bestClusters = IndexVector{};
+
+            size_t nextVector = 0;
+            updateClosestCentersInGroups<T, Bytes, MaxVectors>(data.data(p), centers, nextVector, numOfVectors, laneIndices, bestDistances, bestClusters);
+
+            // Each lane holds its first closest center, so ties go to the lowest index like in the scalar kernels.
+            T distances[Width];
+            Index clusters[Width];
+            std::memcpy(distances, &bestDistances, sizeof(distances));
+            std::memcpy(clusters, &bestClusters, sizeof(clusters));
+
+            T bestDistance = distances[0];
+            Index bestCluster = clusters[0];
+            for (size_t l = 1; l < Width; l++)
+            {
+                if (distances[l] < bestDistance || (distances[l] == bestDistance && clusters[l] < bestCluster))
+                {
+                    bestDistance = distances[l];
+                    bestCluster = clusters[l];
+                }
+            }
+
+            assignments.assign(p, static_cast<size_t>(bestCluster), std::sqrt(static_cast<double>(bestDistance)));
+        }
+    }
+
+    /**
+     * The number of bytes of partial sums per point in `calcSquaredDistancesVectorised`. It is the same
+     * for all instruction sets, so the partial sums and thereby the distances do not depend on the vector width.
+     */
+    const size_t PartialSumBytes = 2 * MaxVectorBytes;
+
+    template <typename T, size_t Bytes>
+    KMEANS_SIMD_INLINE void
+    calcSquaredDistancesVectorised(const blaze::DynamicMatrix<T> &data, size_t centerIndex, size_t beginPoint, size_t endPoint,
+                                   double *squaredDistances)
+    {
+        using Vector = typename SimdVector<T, Bytes>::Vector;
+        constexpr size_t Width = SimdVector<T, Bytes>::Width;
+        constexpr size_t NumPartialSums = PartialSumBytes / sizeof(T);
+        constexpr size_t NumAccumulators = NumPartialSums / Width;
+
+        const size_t d = data.columns();
+        const size_t vectorisedDimensions = d / NumPartialSums * NumPartialSums;
+        const T *center = data.data(centerIndex);
+
+        for (size_t p = beginPoint; p < endPoint; p++)
+        {
+            const T *point = data.data(p);
+
+            // Independent accumulators hide the latency of the additions.
+            Vector sums[NumAccumulators];
+            for (size_t a = 0; a < NumAccumulators; a++)
+            {
+                sums[a] = Vector{};
+            }
+
+            for (size_t j = 0; j < vectorisedDimensions; j += NumPartialSums)
+            {
+                for (size_t a = 0; a < NumAccumulators; a++)
+                {
+                    Vector x, c;
+                    std::memcpy(&x, point + j + a * Width, sizeof(x));
+                    std::memcpy(&c, center + j + a * Width, sizeof(c));
+
+                    const Vector diff = x - c;
+                    const Vector squaredDiff = diff * diff;
+                    sums[a] += squaredDiff;
+                }
+            }
+
+            T partialSums[NumPartialSums];
+            std::memcpy(partialSums, sums, sizeof(partialSums));
+
+            T distance = T(0);
+            for (size_t l = 0; l < NumPartialSums; l++)
+            {
+                distance += partialSums[l];
+            }
+
+            for (size_t j = vectorisedDimensions; j < d; j++)
+            {
+                const T diff = point[j] - center[j];
+                distance += diff * diff;
+            }
+
+            squaredDistances[p - beginPoint] = static_cast<double>(distance);
+        }
+    }
+
+    template <typename T>
+    KMEANS_SIMD_TARGET("sse4.2")
+    void
+    assignClosestCentersSse42(const blaze::DynamicMatrix<T> &data, const PackedCenters<T> &centers, ClusterAssignmentList &assignments, size_t beginPoint, size_t endPoint)
+    {
+        assignClosestCentersVectorised<T, 16, 4>(data, centers, assignments, beginPoint, endPoint);
+    }
+
+    template <typename T>
+    KMEANS_SIMD_TARGET("avx2")
+    void
+    assignClosestCentersAvx2(const blaze::DynamicMatrix<T> &data, const PackedCenters<T> &centers, ClusterAssignmentList &assignments, size_t beginPoint, size_t endPoint)
+    {
+        assignClosestCentersVectorised<T, 32, 8>(data, centers, assignments, beginPoint, endPoint);
+    }
+
+    template <typename T>
+    KMEANS_SIMD_TARGET("avx512f")
+    void
+    assignClosestCentersAvx512(const blaze::DynamicMatrix<T> &data, const PackedCenters<T> &centers, ClusterAssignmentList &assignments, size_t beginPoint, size_t endPoint)
+    {
+        assignClosestCentersVectorised<T, 64, 8>(data, centers, assignments, beginPoint, endPoint);
+    }
+
+    template <typename T>
+    KMEANS_SIMD_TARGET("sse4.2")
+    void
+    calcSquaredDistancesSse42(const blaze::DynamicMatrix<T> &data, size_t centerIndex, size_t beginPoint, size_t endPoint, double *squaredDistances)
+    {
+        calcSquaredDistancesVectorised<T, 16>(data, centerIndex, beginPoint, endPoint, squaredDistances);
+    }
+
+    template <typename T>
+    KMEANS_SIMD_TARGET("avx2")
+    void
+    calcSquaredDistancesAvx2(const blaze::DynamicMatrix<T> &data, size_t centerIndex, size_t beginPoint, size_t endPoint, double *squaredDistances)
+    {
+        calcSquaredDistancesVectorised<T, 32>(data, centerIndex, beginPoint, endPoint, squaredDistances);
+    }
+
+    template <typename T>
+    KMEANS_SIMD_TARGET("avx512f")
+    void
+    calcSquaredDistancesAvx512(const blaze::DynamicMatrix<T> &data, size_t centerIndex, size_t beginPoint, size_t endPoint, double *squaredDistances)
+    {
+        calcSquaredDistancesVectorised<T, 64>(data, centerIndex, beginPoint, endPoint, squaredDistances);
+    }
+#endif
+}
+
+SimdLevel
+clustering::detectSimdLevel()
+{
+#ifdef KMEANS_SIMD_DISPATCH
+    // The checks include whether the operating system saves the wider registers.
+    static const SimdLevel detectedLevel = []
+    {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f"))
+        {
+            return SimdLevel::AVX512;
+        }
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return SimdLevel::AVX2;
+        }
+        if (__builtin_cpu_supports("sse4.2"))
+        {
+            return SimdLevel::SSE42;
+        }
+        return SimdLevel::Scalar;
+    }();
+    return detectedLevel;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+SimdLevel
+clustering::getSimdLevel()
+{
+    int level = activeSimdLevel.load(std::memory_order_relaxed);
+    if (level < 0)
+    {
+        level = static_cast<int>(detectSimdLevel());
+        activeSimdLevel.store(level, std::memory_order_relaxed);
+        KMEANS_LOG_DEBUG("Using %s distance kernels.", getSimdLevelName(static_cast<SimdLevel>(level)));
+    }
+    return static_cast<SimdLevel>(level);
+}
+
+void
+clustering::setSimdLevel(SimdLevel level)
+{
+    const auto supportedLevel = std::min(static_cast<int>(level), static_cast<int>(detectSimdLevel()));
+    activeSimdLevel.store(supportedLevel, std::memory_order_relaxed);
+}
+
+const char *
+clustering::getSimdLevelName(SimdLevel level)
+{
+    switch (level)
+    {
+    case SimdLevel::SSE42:
+        return "SSE4.2";
+    case SimdLevel::AVX2:
+        return "AVX2";
+    case SimdLevel::AVX512:
+        return "AVX-512";
+    case SimdLevel::Scalar:
+    default:
+        return "scalar";
+    }
+}
+
+template <typename T>
+bool
+clustering::assignClosestCentersSimd(const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<T> &centers,
+                                     ClusterAssignmentList &assignments, size_t beginPoint, size_t endPoint)
+{
+#ifdef KMEANS_SIMD_DISPATCH
+    const auto level = getSimdLevel();
+    if (level == SimdLevel::Scalar)
+    {
+        return false;
+    }
+
+    const auto packedCenters = packCenters(centers);
+    switch (level)
+    {
+    case SimdLevel::AVX512:
+        assignClosestCentersAvx512(data, packedCenters, assignments, beginPoint, endPoint);
+        break;
+    case SimdLevel::AVX2:
+        assignClosestCentersAvx2(data, packedCenters, assignments, beginPoint, endPoint);
+        break;
+    default:
+        assignClosestCentersSse42(data, packedCenters, assignments, beginPoint, endPoint);
+        break;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+template <typename T>
+bool
+clustering::calcSquaredDistancesSimd(const blaze::DynamicMatrix<T> &data, size_t centerIndex, size_t beginPoint, size_t endPoint,
+                                     double *squaredDistances)
+{
+#ifdef KMEANS_SIMD_DISPATCH
+    switch (getSimdLevel())
+    {
+    case SimdLevel::AVX512:
+        calcSquaredDistancesAvx512(data, centerIndex, beginPoint, endPoint, squaredDistances);
+        return true;
+    case SimdLevel::AVX2:
+        calcSquaredDistancesAvx2(data, centerIndex, beginPoint, endPoint, squaredDistances);
+        return true;
+    case SimdLevel::SSE42:
+        calcSquaredDistancesSse42(data, centerIndex, beginPoint, endPoint, squaredDistances);
+        return true;
+    case SimdLevel::Scalar:
+    default:
+        return false;
+    }
+#else
+    return false;
+#endif
+}
+
+template bool clustering::assignClosestCentersSimd(const blaze::DynamicMatrix<float> &, const blaze::DynamicMatrix<float> &, ClusterAssignmentList &, size_t, size_t);
+template bool clustering::assignClosestCentersSimd(const blaze::DynamicMatrix<double> &, const blaze::DynamicMatrix<double> &, ClusterAssignmentList &, size_t, size_t);
+
+template bool clustering::calcSquaredDistancesSimd(const blaze::DynamicMatrix<float> &, size_t, size_t, size_t, double *);
+template bool clustering::calcSquaredDistancesSimd(const blaze::DynamicMatrix<double> &, size_t, size_t, size_t, double *);
@@ -0,0 +1,126 @@
+#include <clustering/sparse_assignment.hpp>
+
+using namespace clustering;
+
+template <typename T>
+blaze::DynamicVector<T>
+clustering::calcSquaredRowNorms(const blaze::CompressedMatrix<T> &matrix)
+{
+    blaze::DynamicVector<T> norms(matrix.rows());
+    for (size_t i = 0; i < matrix.rows(); i++)
+    {
+        T norm = T(0);
+        for (auto it = matrix.begin(i); it != matrix.end(i); ++it)
+        {
+            norm += it->value() * it->value();
+        }
+        norms[i] = norm;
+    }
+    return norms;
+}
+
+template <typename T>
+double
+clustering::calcSquaredDistance(const blaze::CompressedMatrix<T> &matrix, size_t p, size_t q)
+{
+    auto itP = matrix.begin(p), endP = matrix.end(p);
+    auto itQ = matrix.begin(q), endQ = matrix.end(q);
+
+    // Merge the nonzero entries of both rows which are sorted by column index.
+    double distance = 0.0;
+    while (itP != endP || itQ != endQ)
+    {
+        double diff;
+        if (itQ == endQ || (itP != endP && itP->index() < itQ->index()))
+        {
+            diff = static_cast<double>(itP->value());
+            ++itP;
+        }
+        else if (itP == endP || itQ->index() < itP->index())
+        {
+            diff = static_cast<double>(itQ->value());
+            ++itQ;
+        }
+        else
+        {
+            diff = static_cast<double>(itP->value()) - static_cast<double>(itQ->value());
+            ++itP;
+            ++itQ;
+        }
+        distance += diff * diff;
+    }
+
+    return distance;
+}
+
+template <typename T>
+void
+clustering::prepareSparseAssignmentCenters(const blaze::DynamicMatrix<T> &centers, blaze::DynamicMatrix<T> &transposedCenters,
+                                           blaze::DynamicVector<T> &centerSquaredNorms)
+{
+    const size_t k = centers.rows();
+    const size_t d = centers.columns();
+
+    centerSquaredNorms.resize(k, false);
+    transposedCenters.resize(d, k, false);
+    for (size_t c = 0; c < k; c++)
+    {
+        centerSquaredNorms[c] = blaze::sqrNorm(blaze::row(centers, c));
+        for (size_t j = 0; j < d; j++)
+        {
+            transposedCenters(j, c) = centers(c, j);
+        }
+    }
+}
+
+template <typename T>
+void
+clustering::assignClosestCentersSparse(const blaze::CompressedMatrix<T> &data, const blaze::DynamicVector<T> &dataSquaredNorms,
+                                       const blaze::DynamicMatrix<T> &transposedCenters, const blaze::DynamicVector<T> &centerSquaredNorms,
+                                       ClusterAssignmentList &assignments, size_t beginPoint, size_t endPoint)
+{
+    const size_t k = transposedCenters.columns();
+
+    std::vector<T> dotProducts(k);
+    for (size_t p = beginPoint; p < endPoint; p++)
+    {
+        // x·c for all centers, visiting only the nonzero entries of x.
+        std::fill(dotProducts.begin(), dotProducts.end(), T(0));
+        for (auto it = data.begin(p); it != data.end(p); ++it)
+        {
+            const T value = it->value();
+            const size_t j = it->index();
+            for (size_t c = 0; c < k; c++)
+            {
+                dotProducts[c] += value * transposedCenters(j, c);
+            }
+        }
+
+        T bestDistance = std::numeric_limits<T>::max();
+        size_t bestCluster = 0;
+        for (size_t c = 0; c < k; c++)
+        {
+            const T distance = dataSquaredNorms[p] - T(2) * dotProducts[c] + centerSquaredNorms[c];
+            if (distance < bestDistance)
+            {
+                bestDistance = distance;
+                bestCluster = c;
+            }
+        }
+
+        // Cancellation can make the squared distance slightly negative.
+        assignments.assign(p, bestCluster, std::sqrt(std::max(0.0, static_cast<double>(bestDistance))));
+    }
+}
+
+template blaze::DynamicVector<float> clustering::calcSquaredRowNorms(const blaze::CompressedMatrix<float> &);
+template blaze::DynamicVector<double> clustering::calcSquaredRowNorms(const blaze::CompressedMatrix<double> &);
+
+template double clustering::calcSquaredDistance(const blaze::CompressedMatrix<float> &, size_t, size_t);
+template double clustering::calcSquaredDistance(const blaze::CompressedMatrix<double> &, size_t, size_t);
+
+template void clustering::prepareSparseAssignmentCenters(const blaze::DynamicMatrix<float> &, blaze::DynamicMatrix<float> &, blaze::DynamicVector<float> &);
+template void clustering::prepareSparseAssignmentCenters(const blaze::DynamicMatrix<double> &, blaze::DynamicMatrix<double> &, blaze::DynamicVector<double> &);
+
+template void clustering::assignClosestCentersSparse(const blaze::CompressedMatrix<float> &, const blaze::DynamicVector<float> &, const blaze::DynamicMatrix<float> &, const blaze::DynamicVector<float> &, ClusterAssignmentList &, size_t, size_t);
+template void clustering::assignClosestCentersSparse(const blaze::CompressedMatrix<double> &, const blaze::DynamicVector<double> &, const blaze::DynamicMatrix<double> &, const blaze::DynamicVector<double> &, ClusterAssignmentList &, size_t, size_t);
@@ -0,0 +1,255 @@
+#include <clustering/yinyang_assignment.hpp>
+
+using namespace clustering;
+
+template <typename T>
+YinyangAssignmentEngine<T>::YinyangAssignmentEngine(size_t n, size_t k, size_t numThreads, size_t t) : BoundedAssignmentEngine<T>(n, k, numThreads),
+                                                                                                       NumOfGroups(t > 0 ? std::min(t, k) : std::max<size_t>(1, k / 10)),
+                                                                                                       centerGroups(k), groupMembers(NumOfGroups),
+                                                                                                       lowerBounds(n, NumOfGroups), groupShifts(NumOfGroups)
+{
+}
+
+template <typename T>
+void
+YinyangAssignmentEngine<T>::prepare(const blaze::DynamicMatrix<T> &centers)
+{
+    if (!isInitialised)
+    {
+        groupCenters(centers);
+        return;
+    }
+
+    // Δ(g) = max_{c in g} δ(c)
+    groupShifts = 0.0;
+    for (size_t c = 0; c < NumOfClusters; c++)
+    {
+        groupShifts[centerGroups[c]] = std::max(groupShifts[centerGroups[c]], centerShifts[c]);
+    }
+}
+
+template <typename T>
+void
+YinyangAssignmentEngine<T>::groupCenters(const blaze::DynamicMatrix<T> &centers)
+{
+    const size_t k = NumOfClusters;
+    const size_t t = NumOfGroups;
+    const size_t groupingIterations = 5;
+
+    // Seed the groups with evenly spaced centers.
+    blaze::DynamicMatrix<T> groupCentroids(t, centers.columns());
+    for (size_t g = 0; g < t; g++)
+    {
+        blaze::row(groupCentroids, g) = blaze::row(centers, g * k / t);
+    }
+
+    blaze::DynamicVector<size_t> groupSizes(t);
+    for (size_t i = 0; i < groupingIterations; i++)
+    {
+        for (size_t c = 0; c < k; c++)
+        {
+            double bestDistance = std::numeric_limits<double>::max();
+            for (size_t g = 0; g < t; g++)
+            {
+                const double d = static_cast<double>(blaze::sqrNorm(blaze::row(centers, c) - blaze::row(groupCentroids, g)));
+                if (d < bestDistance)
+                {
+                    bestDistance = d;
+                    centerGroups[c] = g;
+                }
+            }
+        }
+
+        groupSizes = 0;
+        blaze::DynamicMatrix<T> sums(t, centers.columns(), T(0));
+        for (size_t c = 0; c < k; c++)
+        {
+            blaze::row(sums, centerGroups[c]) += blaze::row(centers, c);
+            groupSizes[centerGroups[c]] += 1;
+        }
+
+        for (size_t g = 0; g < t; g++)
+        {
+            // Keep the previous centroid of an empty group.
+            if (groupSizes[g] > 0)
+            {
+                blaze::row(groupCentroids, g) = blaze::row(sums, g) / static_cast<T>(groupSizes[g]);
+            }
+        }
+    }
+
+    for (size_t c = 0; c < k; c++)
+    {
+        groupMembers[centerGroups[c]].push_back(c);
+    }
+}
+
+template <typename T>
+void
+YinyangAssignmentEngine<T>::initialiseBounds(const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<T> &centers, ClusterAssignmentList &assignments, size_t beginPoint, size_t endPoint)
+{
+    std::vector<double> closestInGroup(NumOfGroups), secondClosestInGroup(NumOfGroups);
+
+    for (size_t p = beginPoint; p < endPoint; p++)
+    {
+        double bestDistance = std::numeric_limits<double>::max();
+        size_t bestCluster = 0;
+
+        for (size_t g = 0; g < NumOfGroups; g++)
+        {
+            closestInGroup[g] = std::numeric_limits<double>::max();
+            secondClosestInGroup[g] = std::numeric_limits<double>::max();
+
+            for (size_t c : groupMembers[g])
+            {
+                const double d = distance(data, p, centers, c);
+
+                if (d < closestInGroup[g])
+                {
+                    secondClosestInGroup[g] = closestInGroup[g];
+                    closestInGroup[g] = d;
+                }
+                else if (d < secondClosestInGroup[g])
+                {
+                    secondClosestInGroup[g] = d;
+                }
+
+                if (d < bestDistance)
+                {
+                    bestDistance = d;
+                    bestCluster = c;
+                }
+            }
+        }
+
+        // The lower bound of a group excludes the assigned center.
+        for (size_t g = 0; g < NumOfGroups; g++)
+        {
+            lowerBounds(p, g) = (g == centerGroups[bestCluster]) ? secondClosestInGroup[g] : closestInGroup[g];
+        }
+
+        upperBounds[p] = bestDistance;
+        upperBoundIsTight[p] = true;
+        assignments.assign(p, bestCluster, bestDistance);
+    }
+}
+
+template <typename T>
+void
+YinyangAssignmentEngine<T>::updateAssignments(const blaze::DynamicMatrix<T> &data, const blaze::DynamicMatrix<T> &centers, ClusterAssignmentList &assignments, size_t beginPoint, size_t endPoint)
+{
+    // Scratch space used when scanning the groups of a single point.
+    std::vector<double> previousLowerBounds(NumOfGroups), closestInGroup(NumOfGroups), secondClosestInGroup(NumOfGroups);
+    std::vector<size_t> closestCenterInGroup(NumOfGroups);
+    std::vector<char> groupScanned(NumOfGroups);
+
+    for (size_t p = beginPoint; p < endPoint; p++)
+    {
+        const size_t a = assignments.getCluster(p);
+
+        upperBounds[p] += centerShifts[a];
+        if (centerShifts[a] > 0.0)
+        {
+            upperBoundIsTight[p] = false;
+        }
+
+        // Global filter: if u(p) is below every group lower bound, the assignment cannot change.
+        double globalLowerBound = std::numeric_limits<double>::max();
+        for (size_t g = 0; g < NumOfGroups; g++)
+        {
+            previousLowerBounds[g] = lowerBounds(p, g);
+            lowerBounds(p, g) -= groupShifts[g];
+            globalLowerBound = std::min(globalLowerBound, lowerBounds(p, g));
+        }
+
+        if (upperBounds[p] <= globalLowerBound)
+        {
+            assignments.assign(p, a, upperBounds[p]);
+            continue;
+        }
+
+        upperBounds[p] = distance(data, p, centers, a);
+        upperBoundIsTight[p] = true;
+        if (upperBounds[p] <= globalLowerBound)
+        {
+            assignments.assign(p, a, upperBounds[p]);
+            continue;
+        }
+
+        size_t bestCluster = a;
+        double bestDistance = upperBounds[p];
+
+        for (size_t g = 0; g < NumOfGroups; g++)
+        {
+            // Group filter: no center in the group can be closer than the best one so far.
+            groupScanned[g] = lowerBounds(p, g) < bestDistance;
+            if (!groupScanned[g])
+            {
+                continue;
+            }
+
+            closestInGroup[g] = std::numeric_limits<double>::max();
+            secondClosestInGroup[g] = std::numeric_limits<double>::max();
+            closestCenterInGroup[g] = NumOfClusters;
+
+            for (size_t c : groupMembers[g])
+            {
+                double d;
+                if (c == a)
+                {
+                    d = upperBounds[p];
+                }
+                else
+                {
+                    // Local filter: lb(p, g) from the previous iteration minus δ(c) bounds d(p, c).
+                    const double centerLowerBound = previousLowerBounds[g] - centerShifts[c];
+                    if (centerLowerBound >= bestDistance)
+                    {
+                        d = centerLowerBound;
+                    }
+                    else
+                    {
+                        d = distance(data, p, centers, c);
+                        if (d < bestDistance)
+                        {
+                            bestDistance = d;
+                            bestCluster = c;
+                        }
+                    }
+                }
+
+                if (d < closestInGroup[g])
+                {
+                    secondClosestInGroup[g] = closestInGroup[g];
+                    closestInGroup[g] = d;
+                    closestCenterInGroup[g] = c;
+                }
+                else if (d < secondClosestInGroup[g])
+                {
+                    secondClosestInGroup[g] = d;
+                }
+            }
+        }
+
+        for (size_t g = 0; g < NumOfGroups; g++)
+        {
+            if (groupScanned[g])
+            {
+                lowerBounds(p, g) = (closestCenterInGroup[g] == bestCluster) ? secondClosestInGroup[g] : closestInGroup[g];
+            }
+        }
+
+        // The previously assigned center now counts towards the lower bound of its group.
+        const size_t previousGroup = centerGroups[a];
+        if (bestCluster != a && !groupScanned[previousGroup])
+        {
+            lowerBounds(p, previousGroup) = std::min(lowerBounds(p, previousGroup), upperBounds[p]);
+        }
+
+        upperBounds[p] = bestDistance;
+        assignments.assign(p, bestCluster, bestDistance);
+    }
+}
+
+template class clustering::YinyangAssignmentEngine<float>;
+template class clustering::YinyangAssignmentEngine<double>;
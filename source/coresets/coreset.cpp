@@ -1,70 +1,240 @@
 #include <coresets/coreset.hpp>
-#include <map>
 
 using namespace coresets;
 
+namespace
+{
+    /**
+     * The number of rows ahead of the copied row whose source is prefetched by `Coreset::materialise`.
+     */
+    const size_t MaterialisePrefetchDistance = 8;
+
+    /**
+     * The size of the cache lines which are prefetched.
+     */
+    const size_t PrefetchLineBytes = 64;
+
+    /**
+     * The smallest number of slots in the hash table of a coreset.
+     */
+    const size_t MinHashSlots = 16;
+
+    /**
+     * Mixes the bits of an entry key with the finaliser of SplitMix64, so consecutive point indices spread over the slots.
+     */
+    inline size_t
+    hashEntry(size_t index, bool isCenter)
+    {
+        uint64_t key = (index << 1) | (isCenter ? 1 : 0);
+        key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+        return key ^ (key >> 31);
+    }
+
+    template <typename T>
+    inline void
+    prefetchRow(const T *row, size_t numOfColumns)
+    {
+#if defined(__GNUC__)
+        const char *bytes = reinterpret_cast<const char *>(row);
+        for (size_t offset = 0; offset < numOfColumns * sizeof(T); offset += PrefetchLineBytes)
+        {
+            __builtin_prefetch(bytes + offset);
+        }
+#else
+        (void)row;
+        (void)numOfColumns;
+#endif
+    }
+}
+
 Coreset::Coreset(size_t targetSize) : TargetSize(targetSize)
 {
+    // The builders add about T points and k centers, so the table rarely has to grow.
+    indices.reserve(targetSize);
+    weights.reserve(targetSize);
+    centerFlags.reserve(targetSize);
+    rehash(std::max<size_t>(MinHashSlots, 2 * targetSize));
 }
 
-std::shared_ptr<WeightedPoint>
-Coreset::findPoint(size_t index, bool isCenter)
+size_t
+Coreset::findPosition(size_t index, bool isCenter) const
 {
-    for (size_t i = 0; i < this->points.size(); i++)
+    const size_t mask = slots.size() - 1;
+    for (size_t slot = hashEntry(index, isCenter) & mask; slots[slot] != 0; slot = (slot + 1) & mask)
     {
-        if (points[i]->Index == index && points[i]->IsCenter == isCenter)
+        const size_t position = slots[slot] - 1;
+        if (indices[position] == index && (centerFlags[position] != 0) == isCenter)
         {
-            return points[i];
+            return position;
         }
     }
 
-    return nullptr;
+    return indices.size();
 }
 
-void Coreset::addPoint(size_t pointIndex, double weight)
+size_t
+Coreset::addWeight(size_t index, bool isCenter, double weight)
 {
-    auto coresetPoint = findPoint(pointIndex, false);
-    if (coresetPoint == nullptr)
+    const size_t mask = slots.size() - 1;
+    size_t slot = hashEntry(index, isCenter) & mask;
+    for (; slots[slot] != 0; slot = (slot + 1) & mask)
     {
-        coresetPoint = std::make_shared<WeightedPoint>(pointIndex, 0.0, false);
-        this->points.push_back(coresetPoint);
-        printf("            Adding");
-    } 
-    else
+        const size_t position = slots[slot] - 1;
+        if (indices[position] == index && (centerFlags[position] != 0) == isCenter)
+        {
+            weights[position] += weight;
+            return position;
+        }
+    }
+
+    const size_t position = indices.size();
+    indices.push_back(index);
+    weights.push_back(weight);
+    centerFlags.push_back(isCenter ? 1 : 0);
+    slots[slot] = position + 1;
+
+    // Keep the load factor at most one half so the probe sequences stay short.
+    if (2 * indices.size() > slots.size())
     {
-        printf("            Updating");
+        rehash(2 * slots.size());
     }
-    
-    coresetPoint->Weight += weight;
-    printf(" point %ld with weight %0.2f to the coreset\n", coresetPoint->Index, coresetPoint->Weight);
+
+    return position;
 }
 
-void Coreset::addCenter(size_t clusterIndex, double weight)
+void
+Coreset::rehash(size_t numOfSlots)
 {
-    auto coresetPoint = findPoint(clusterIndex, true);
-    if (coresetPoint == nullptr)
+    size_t capacity = MinHashSlots;
+    while (capacity < numOfSlots)
     {
-        coresetPoint = std::make_shared<WeightedPoint>(clusterIndex, 0.0, true);
-        this->points.push_back(coresetPoint);
-        printf("            Adding");
-    } 
-    else
+        capacity *= 2;
+    }
+
+    slots.assign(capacity, 0);
+    const size_t mask = capacity - 1;
+    for (size_t position = 0; position < indices.size(); position++)
+    {
+        size_t slot = hashEntry(indices[position], centerFlags[position] != 0) & mask;
+        while (slots[slot] != 0)
+        {
+            slot = (slot + 1) & mask;
+        }
+        slots[slot] = position + 1;
+    }
+}
+
+std::shared_ptr<WeightedPoint>
+Coreset::findPoint(size_t index, bool isCenter) const
+{
+    const size_t position = findPosition(index, isCenter);
+    if (position == indices.size())
     {
-        printf("            Updating");
+        return nullptr;
     }
-    coresetPoint->Weight += weight;
 
-    printf(" center c_%ld with weight %0.2f to the coreset\n", coresetPoint->Index, coresetPoint->Weight);
+    return this->at(position);
+}
+
+void Coreset::addPoint(size_t pointIndex, double weight)
+{
+    const size_t numOfEntries = indices.size();
+    const size_t position = addWeight(pointIndex, false, weight);
+    [[maybe_unused]] const bool isNewPoint = position == numOfEntries;
+    KMEANS_LOG_TRACE("            %s point %ld with weight %0.2f to the coreset", isNewPoint ? "Adding" : "Updating", pointIndex, weights[position]);
+}
+
+void Coreset::addCenter(size_t clusterIndex, double weight)
+{
+    const size_t numOfEntries = indices.size();
+    const size_t position = addWeight(clusterIndex, true, weight);
+    [[maybe_unused]] const bool isNewPoint = position == numOfEntries;
+    KMEANS_LOG_TRACE("            %s center c_%ld with weight %0.2f to the coreset", isNewPoint ? "Adding" : "Updating", clusterIndex, weights[position]);
 }
 
 std::shared_ptr<WeightedPoint>
 Coreset::at(size_t index) const
 {
-    return this->points[index];
+    return std::make_shared<WeightedPoint>(indices[index], weights[index], centerFlags[index] != 0);
+}
+
+size_t
+Coreset::getIndex(size_t index) const
+{
+    return indices[index];
+}
+
+double
+Coreset::getWeight(size_t index) const
+{
+    return weights[index];
+}
+
+bool
+Coreset::isCenter(size_t index) const
+{
+    return centerFlags[index] != 0;
 }
 
 size_t
 Coreset::size() const
 {
-    return this->points.size();
+    return indices.size();
+}
+
+template <typename T>
+std::shared_ptr<WeightedMatrix<T>>
+Coreset::materialise(const blaze::DynamicMatrix<T> &data, const std::shared_ptr<clustering::ClusteringResult> result, size_t numThreads) const
+{
+    const size_t n = this->size();
+    const size_t d = data.columns();
+    const auto &centroids = result->getCentroids();
+
+    if (centroids.columns() != d)
+    {
+        throw std::invalid_argument("The centroids must have the dimensions of the data.");
+    }
+
+    // Look up the rows before copying so an invalid coreset leaves no partially filled matrix.
+    blaze::DynamicVector<double> gatheredWeights(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        if (indices[i] >= (centerFlags[i] != 0 ? centroids.rows() : data.rows()))
+        {
+            throw std::invalid_argument("The coreset refers to a point or a center which is not in the data or the clustering.");
+        }
+        gatheredWeights[i] = weights[i];
+    }
+
+    blaze::DynamicMatrix<T> gatheredPoints(n, d);
+    utils::parallelFor(0, n, utils::resolveNumberOfThreads(numThreads), [&](size_t beginPoint, size_t endPoint)
+                       {
+                           for (size_t i = beginPoint; i < endPoint; i++)
+                           {
+                               // The sampled rows are scattered over the data, so their loads are started early.
+                               const size_t ahead = i + MaterialisePrefetchDistance;
+                               if (ahead < endPoint && centerFlags[ahead] == 0)
+                               {
+                                   prefetchRow(data.data(indices[ahead]), d);
+                               }
+
+                               if (centerFlags[i] != 0)
+                               {
+                                   for (size_t j = 0; j < d; j++)
+                                   {
+                                       gatheredPoints(i, j) = static_cast<T>(centroids(indices[i], j));
+                                   }
+                               }
+                               else
+                               {
+                                   blaze::row(gatheredPoints, i) = blaze::row(data, indices[i]);
+                               }
+                           }
+                       });
+
+    return std::make_shared<WeightedMatrix<T>>(std::move(gatheredPoints), std::move(gatheredWeights));
 }
+
+template std::shared_ptr<WeightedMatrix<float>> Coreset::materialise(const blaze::DynamicMatrix<float> &, const std::shared_ptr<clustering::ClusteringResult>, size_t) const;
+template std::shared_ptr<WeightedMatrix<double>> Coreset::materialise(const blaze::DynamicMatrix<double> &, const std::shared_ptr<clustering::ClusteringResult>, size_t) const;
@@ -2,22 +2,32 @@
 
 using namespace coresets;
 
-GroupSampling::GroupSampling(size_t numberOfClusters, size_t targetSamplesInCoreset, size_t beta, size_t groupRangeSize, size_t minimumGroupSamplingSize) : NumberOfClusters(numberOfClusters),
-                                                                                                                                                            TargetSamplesInCoreset(targetSamplesInCoreset),
-                                                                                                                                                            Beta(beta),
-                                                                                                                                                            GroupRangeSize(groupRangeSize),
-                                                                                                                                                            MinimumGroupSamplingSize(minimumGroupSamplingSize)
+GroupSampling::GroupSampling(size_t numberOfClusters, size_t targetSamplesInCoreset, size_t beta, size_t groupRangeSize, size_t minimumGroupSamplingSize, size_t numThreads) : NumberOfClusters(numberOfClusters),
+                                                                                                                                                                               TargetSamplesInCoreset(targetSamplesInCoreset),
+                                                                                                                                                                               Beta(beta),
+                                                                                                                                                                               GroupRangeSize(groupRangeSize),
+                                                                                                                                                                               MinimumGroupSamplingSize(minimumGroupSamplingSize),
+                                                                                                                                                                               NumThreads(numThreads)
 {
 }
 
+template <typename T>
 std::shared_ptr<Coreset>
-GroupSampling::run(const blaze::DynamicMatrix<double> &data)
+GroupSampling::run(const blaze::DynamicMatrix<T> &data)
 {
     clustering::KMeans kMeansAlg(this->NumberOfClusters);
+    kMeansAlg.enableCheckpoints(this->checkpointPath, this->checkpointInterval);
     auto clusters = kMeansAlg.run(data);
     return run(clusters);
 }
 
+void
+GroupSampling::enableCheckpoints(const std::string &filePath, size_t interval)
+{
+    this->checkpointPath = filePath;
+    this->checkpointInterval = interval;
+}
+
 std::shared_ptr<Coreset>
 GroupSampling::run(const std::shared_ptr<clustering::ClusteringResult> result)
 {
@@ -29,6 +39,9 @@ GroupSampling::run(const std::shared_ptr<clustering::ClusteringResult> result)
 
     auto groups = std::make_shared<GroupSet>(this->GroupRangeSize);
 
+    // Each point is put into at most one group.
+    groups->reserve(clusterAssignments.getNumberOfPoints());
+
     groupRingPoints(clusterAssignments, rings, groups);
 
     groupOvershotPoints(clusterAssignments, rings, groups);
@@ -46,68 +59,31 @@ GroupSampling::makeRings(const clustering::ClusterAssignmentList &clusterAssignm
     const int ringRangeStart = -static_cast<int>(floor(std::log10(static_cast<double>(Beta))));
     const int ringRangeEnd = -ringRangeStart;
     const auto n = clusterAssignments.getNumberOfPoints();
-    const auto k = clusterAssignments.getNumberOfClusters();
-
-    auto rings = std::make_shared<RingSet>(ringRangeStart, ringRangeEnd, k);
 
     // Step 2: Compute the average cost for each cluster.
     auto averageClusterCosts = clusterAssignments.calcAverageClusterCosts();
 
-    for (size_t p = 0; p < n; p++)
-    {
-        // The cluster index of point `p`
-        size_t c = clusterAssignments.getCluster(p);
-
-        // The cost of point `p`: cost(p, A)
-        double costOfPoint = clusterAssignments.getPointCost(p);
-
-        // The average cost of cluster `c`: Δ_c
-        double averageClusterCost = (*averageClusterCosts)[c];
-
-        bool pointPutInRing = false;
-        for (int l = ringRangeStart; l <= ringRangeEnd; l++)
-        {
-            auto ring = rings->findOrCreate(c, l, averageClusterCost);
-
-            // Add point if cost(p, A) is within bounds i.e. between Δ_c*2^l and Δ_c*2^(l+1)
-            if (ring->tryAddPoint(p, costOfPoint))
-            {
-                pointPutInRing = true;
-
-                // Since a point cannot belong to multiple rings, there is no need to
-                // test whether the point `p` falls within the ring of the next range l+1.
-                break;
-            }
-        }
+    auto rings = std::make_shared<RingSet>(ringRangeStart, ringRangeEnd, *averageClusterCosts);
 
-        if (pointPutInRing == false)
-        {
-            double innerMostRingCost = averageClusterCost * std::pow(2, ringRangeStart);
-            double outerMostRingCost = averageClusterCost * std::pow(2, ringRangeEnd + 1);
+    // The range value of the ring of each point is computed in O(1) in one parallel pass. Points are then
+    // bucketed in the order of the points, so the rings do not depend on the number of threads.
+    std::vector<int> rangeValues(n);
+    utils::parallelFor(0, n, utils::resolveNumberOfThreads(this->NumThreads), [&](size_t beginPoint, size_t endPoint)
+                       {
+                           for (size_t p = beginPoint; p < endPoint; p++)
+                           {
+                               rangeValues[p] = rings->findRangeValue(clusterAssignments.getCluster(p), clusterAssignments.getPointCost(p));
+                           }
+                       });
 
-            if (costOfPoint < innerMostRingCost)
-            {
-                // Track shortfall points: below l's lower range i.e. l<log⁡(1/β)
-                rings->addShortfallPoint(p, c, costOfPoint, innerMostRingCost);
-            }
-            else if (costOfPoint > outerMostRingCost)
-            {
-                // Track overshot points: above l's upper range i.e., l>log⁡(β)
-                rings->addOvershotPoint(p, c, costOfPoint, innerMostRingCost);
-            }
-            else
-            {
-                throw std::logic_error("Point should either belong to a ring or be ringless.");
-            }
-        }
-    }
+    rings->addPoints(clusterAssignments, rangeValues);
 
     return rings;
 }
 
 void GroupSampling::addShortfallPointsToCoreset(const clustering::ClusterAssignmentList &clusters, const std::shared_ptr<RingSet> rings, std::shared_ptr<Coreset> coresetContainer)
 {
-    printf("\n\nAdding shortfall points to the coreset..\n");
+    KMEANS_LOG_DEBUG("Adding shortfall points to the coreset..");
 
     // Handle points whose costs are below the lowest ring range i.e. l < log(1/beta).
     // These are called shortfall points because they fall short of being captured by the
@@ -142,14 +118,14 @@ void GroupSampling::groupOvershotPoints(const clustering::ClusterAssignmentList
     double kDouble = static_cast<double>(k);
     double totalCost = rings->computeCostOfOvershotPoints();
 
-    printf("\n\nGrouping overshot points, cost(O) = %0.5f\n", totalCost);
+    KMEANS_LOG_DEBUG("Grouping overshot points, cost(O) = %0.5f", totalCost);
 
     for (size_t c = 0; c < k; c++)
     {
         double clusterCost = rings->computeCostOfOvershotPoints(c);
         auto points = rings->getOvershotPoints(c);
 
-        printf("    Cluster i=%ld  - cost(C_i ⋂ O) = %0.4f     |C_i ⋂ O| = %ld\n", c, clusterCost, points.size());
+        KMEANS_LOG_DEBUG("    Cluster i=%ld  - cost(C_i ⋂ O) = %0.4f     |C_i ⋂ O| = %ld", c, clusterCost, points.size());
 
         if (points.size() == 0)
         {
@@ -169,12 +145,12 @@ void GroupSampling::groupOvershotPoints(const clustering::ClusterAssignmentList
                 // Group 0 has no upper bound. Notice this can be written as two-liners,
                 // but is expanded to make it easier to read the code.
                 shouldAddPointsIntoGroup = clusterCost >= lowerBound;
-                printf("\n      Group j=%ld    lowerBoundCost=%0.4f\n", j, lowerBound);
+                KMEANS_LOG_DEBUG("      Group j=%ld    lowerBoundCost=%0.4f", j, lowerBound);
             }
             else
             {
                 shouldAddPointsIntoGroup = clusterCost >= lowerBound && clusterCost < upperBound;
-                printf("\n      Group j=%ld    lowerBoundCost=%0.4f   upperBoundCost=%0.4f\n", j, lowerBound, upperBound);
+                KMEANS_LOG_DEBUG("      Group j=%ld    lowerBoundCost=%0.4f   upperBoundCost=%0.4f", j, lowerBound, upperBound);
             }
 
             if (shouldAddPointsIntoGroup)
@@ -182,12 +158,11 @@ void GroupSampling::groupOvershotPoints(const clustering::ClusterAssignmentList
                 auto l = std::numeric_limits<int>().max();
                 auto group = groups->create(j, l, lowerBound, upperBound);
 
-                printf("            Adding %ld points to G[l=%d, j=%ld]\n", points.size(), l, j);
+                KMEANS_LOG_DEBUG("            Adding %ld points to G[l=%d, j=%ld]", points.size(), l, j);
 
                 for (size_t i = 0; i < points.size(); i++)
                 {
-                    auto point = points[i];
-                    group->addPoint(point->PointIndex, point->ClusterIndex, point->PointCost);
+                    group->addPoint(points.getPointIndex(i), points.getClusterIndex(i), points.getCost(i));
                 }
             }
         }
@@ -202,7 +177,7 @@ void GroupSampling::groupRingPoints(const clustering::ClusterAssignmentList &clu
         double ringCost = rings->calcRingCost(l);
         size_t nRingPointsForAllClusters = rings->countRingPoints(l);
         size_t nGroupedPoints = 0;
-        printf("\n\nRing l=%d   -  cost(R_l) = %0.4f   -   |R_l| = %ld\n", l, ringCost, nRingPointsForAllClusters);
+        KMEANS_LOG_DEBUG("Ring l=%d   -  cost(R_l) = %0.4f   -   |R_l| = %ld", l, ringCost, nRingPointsForAllClusters);
 
         for (size_t c = 0; c < k; c++)
         {
@@ -210,7 +185,7 @@ void GroupSampling::groupRingPoints(const clustering::ClusterAssignmentList &clu
             auto clusterCost = ring->getTotalCost();
             auto ringPoints = ring->getPoints();
 
-            printf("    Cluster i=%ld  - cost(R_{l,i}) = %0.4f     |R_{l,i}| = %ld\n", c, clusterCost, ring->countPoints());
+            KMEANS_LOG_DEBUG("    Cluster i=%ld  - cost(R_{l,i}) = %0.4f     |R_{l,i}| = %ld", c, clusterCost, ring->countPoints());
 
             if (ring->countPoints() == 0)
             {
@@ -230,24 +205,23 @@ void GroupSampling::groupRingPoints(const clustering::ClusterAssignmentList &clu
                     // Group 0 has no upper bound. Notice this can be written as two-liners,
                     // but is expanded to make it easier to read the code.
                     shouldAddPointsIntoGroup = clusterCost >= lowerBound;
-                    printf("\n      Group j=%ld    lowerBoundCost=%0.4f\n", j, lowerBound, upperBound);
+                    KMEANS_LOG_DEBUG("      Group j=%ld    lowerBoundCost=%0.4f", j, lowerBound);
                 }
                 else
                 {
                     shouldAddPointsIntoGroup = clusterCost >= lowerBound && clusterCost < upperBound;
-                    printf("\n      Group j=%ld    lowerBoundCost=%0.4f   upperBoundCost=%0.4f\n", j, lowerBound, upperBound);
+                    KMEANS_LOG_DEBUG("      Group j=%ld    lowerBoundCost=%0.4f   upperBoundCost=%0.4f", j, lowerBound, upperBound);
                 }
 
                 if (shouldAddPointsIntoGroup)
                 {
                     // Points which belong to cluster `c` and ring `l`
-                    printf("            Adding %ld points to G[l=%d, j=%ld]\n", ringPoints.size(), l, j);
+                    KMEANS_LOG_DEBUG("            Adding %ld points to G[l=%d, j=%ld]", ringPoints.size(), l, j);
 
                     auto group = groups->create(j, l, lowerBound, upperBound);
                     for (size_t i = 0; i < ringPoints.size(); i++)
                     {
-                        auto ringPoint = ringPoints[i];
-                        group->addPoint(ringPoint->PointIndex, ringPoint->ClusterIndex, ringPoint->Cost);
+                        group->addPoint(ringPoints.getPointIndex(i), ringPoints.getClusterIndex(i), ringPoints.getCost(i));
                         nGroupedPoints++;
                     }
                 }
@@ -256,9 +230,8 @@ void GroupSampling::groupRingPoints(const clustering::ClusterAssignmentList &clu
 
         if (nRingPointsForAllClusters != nGroupedPoints)
         {
-            printf("Not all points in ring l=%d are put in a group. ", l);
-            printf("Number of points in the ring is %ld but only %ld points are grouped.\n",
-                   nRingPointsForAllClusters, nGroupedPoints);
+            KMEANS_LOG_WARNING("Not all points in ring l=%d are put in a group. Number of points in the ring is %ld but only %ld points are grouped.",
+                               l, nRingPointsForAllClusters, nGroupedPoints);
         }
         assert(nRingPointsForAllClusters == nGroupedPoints);
     }
@@ -267,7 +240,7 @@ void GroupSampling::groupRingPoints(const clustering::ClusterAssignmentList &clu
 void GroupSampling::addSampledPointsFromGroupsToCoreset(const clustering::ClusterAssignmentList &clusterAssignments, const std::shared_ptr<GroupSet> groups, std::shared_ptr<Coreset> coresetContainer)
 {
     utils::Random random;
-    printf("\n\nSampling from groups...\n");
+    KMEANS_LOG_DEBUG("Sampling from groups...");
 
     const size_t minSamplingSize = 1;
     auto T = coresetContainer->TargetSize;
@@ -275,9 +248,9 @@ void GroupSampling::addSampledPointsFromGroupsToCoreset(const clustering::Cluste
     auto totalCost = clusterAssignments.getTotalCost();
     auto k = clusterAssignments.getNumberOfClusters();
 
-    printf("  Minimum size before sampling from any group is %ld...\n", minSamplingSize);
-    printf("  cost(A) = %0.5f...\n", totalCost);
-    printf("  T = %ld...\n", T);
+    KMEANS_LOG_DEBUG("  Minimum size before sampling from any group is %ld...", minSamplingSize);
+    KMEANS_LOG_DEBUG("  cost(A) = %0.5f...", totalCost);
+    KMEANS_LOG_DEBUG("  T = %ld...", T);
 
     // The number of remaining points needed for the coreset.
     size_t T_remaining = T;
@@ -296,12 +269,12 @@ void GroupSampling::addSampledPointsFromGroupsToCoreset(const clustering::Cluste
         auto normalizedGroupCost = groupCost / totalCost;
         auto numSamples = T * normalizedGroupCost;
 
-        printf("\n    Group m=%ld:   |G_m|=%2ld   cost(G_m)=%2.4f   cost(G_m)/cost(A)=%0.4f   T_m=%0.5f \n",
-               m, groupPoints.size(), group->calcTotalCost(), normalizedGroupCost, numSamples);
+        KMEANS_LOG_DEBUG("    Group m=%ld:   |G_m|=%2ld   cost(G_m)=%2.4f   cost(G_m)/cost(A)=%0.4f   T_m=%0.5f",
+                         m, groupPoints.size(), group->calcTotalCost(), normalizedGroupCost, numSamples);
 
         if (numSamples < minSamplingSize)
         {
-            printf("        Will not sample because T_m is below threshold...\n");
+            KMEANS_LOG_DEBUG("        Will not sample because T_m is below threshold...");
             for (size_t c = 0; c < k; c++)
             {
                 auto nPointsInCluster = group->countPointsInCluster(c);
@@ -314,23 +287,23 @@ void GroupSampling::addSampledPointsFromGroupsToCoreset(const clustering::Cluste
         }
         else if (numSamples >= groupPoints.size())
         {
-            printf("        Will not sample because T_m >= |G_m|.\n");
+            KMEANS_LOG_DEBUG("        Will not sample because T_m >= |G_m|.");
             for (size_t i = 0; i < groupPoints.size(); i++)
             {
-                coresetContainer->addPoint(groupPoints[i]->PointIndex, 1.0);
+                coresetContainer->addPoint(groupPoints.getPointIndex(i), 1.0);
             }
             T_remaining -= groupPoints.size();
         }
         else
         {
-            printf("        Will sample later.\n");
+            KMEANS_LOG_DEBUG("        Will sample later.");
             samplingGroupIndices.push_back(m);
             samplingGroupTotalCost += groupCost;
         }
     }
 
     // Now, we have to deal with the groups that we can sample points from.
-    printf("\n\nDealing with the groups that we can sample points from...");
+    KMEANS_LOG_DEBUG("Dealing with the groups that we can sample points from...");
     for (auto &m : samplingGroupIndices)
     {
         auto group = groups->at(m);
@@ -340,17 +313,18 @@ void GroupSampling::addSampledPointsFromGroupsToCoreset(const clustering::Cluste
         auto numSamplesReal = T_remaining * normalizedGroupCost;
         auto numSamplesInt = random.stochasticRounding(numSamplesReal);
 
-        printf("\n    Group m=%ld:   |G_m|=%2ld   cost(G_m)=%2.4f   cost(G_m)/cost(A)=%0.4f   T_m=%0.5f  round(T_m)=%ld \n",
-               m, groupPoints.size(), group->calcTotalCost(), normalizedGroupCost, numSamplesReal, numSamplesInt);
+        KMEANS_LOG_DEBUG("    Group m=%ld:   |G_m|=%2ld   cost(G_m)=%2.4f   cost(G_m)/cost(A)=%0.4f   T_m=%0.5f  round(T_m)=%ld",
+                         m, groupPoints.size(), group->calcTotalCost(), normalizedGroupCost, numSamplesReal, numSamplesInt);
 
-        auto sampledPoints = random.choice(groupPoints, numSamplesInt);
+        // Sample positions within the group, which picks the same points as sampling from a list of the points.
+        auto pointSampler = random.getIndexer(groupPoints.size());
 
-        printf("        Sampled points from group:\n");
-        for (size_t i = 0; i < sampledPoints.size(); i++)
+        KMEANS_LOG_DEBUG("        Sampled points from group:");
+        for (size_t i = 0; i < numSamplesInt; i++)
         {
-            auto sampledPoint = sampledPoints[i];
-            auto weight = groupCost / (numSamplesInt * sampledPoint->Cost);
-            coresetContainer->addPoint(sampledPoint->PointIndex, weight);
+            const size_t sampledPosition = pointSampler.next();
+            auto weight = groupCost / (numSamplesInt * groupPoints.getCost(sampledPosition));
+            coresetContainer->addPoint(groupPoints.getPointIndex(sampledPosition), weight);
         }
     }
 }
@@ -362,56 +336,71 @@ void GroupSampling::printPythonCodeForVisualisation(std::shared_ptr<clustering::
     auto k = clusterAssignments.getNumberOfClusters();
     auto n = clusterAssignments.getNumberOfPoints();
 
-    printf("k = %ld\n", k);
-    printf("cluster_labels = [");
+    KMEANS_LOG_INFO("k = %ld", k);
+
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(5);
+    line << "cluster_labels = [";
     for (size_t p = 0; p < n; p++)
     {
-        printf("%ld, ", clusterAssignments.getCluster(p));
+        line << clusterAssignments.getCluster(p) << ", ";
     }
-    printf("]\n");
+    line << "]";
+    KMEANS_LOG_INFO("%s", line.str().c_str());
 
-    printf("cluster_centers = np.array([\n");
+    KMEANS_LOG_INFO("cluster_centers = np.array([");
     for (size_t c = 0; c < centers.rows(); c++)
     {
-        printf("  [");
+        line.str("");
+        line << "  [";
         for (size_t d = 0; d < centers.columns(); d++)
         {
-            printf("%0.5f, ", centers.at(c, d));
+            line << centers.at(c, d) << ", ";
         }
-        printf("],\n");
+        line << "],";
+        KMEANS_LOG_INFO("%s", line.str().c_str());
     }
-    printf("])\n");
+    KMEANS_LOG_INFO("])");
 
-    printf("ring_ranges = [");
+    line.str("");
+    line << "ring_ranges = [";
     for (int l = rings->RangeStart; l <= rings->RangeEnd; l++)
     {
-        printf("%d, ", l);
+        line << l << ", ";
     }
-    printf("]\n");
+    line << "]";
+    KMEANS_LOG_INFO("%s", line.str().c_str());
 
-    printf("rings = np.array([\n");
+    KMEANS_LOG_INFO("rings = np.array([");
     for (size_t c = 0; c < k; c++)
     {
-        printf("  [");
+        line.str("");
+        line << "  [";
         for (int l = rings->RangeStart; l <= rings->RangeEnd; l++)
         {
             auto ring = rings->find(c, l);
-            printf("%0.5f, ", ring->getLowerBoundCost());
+            line << ring->getLowerBoundCost() << ", ";
         }
-        printf("],\n");
+        line << "],";
+        KMEANS_LOG_INFO("%s", line.str().c_str());
     }
-    printf("])\n");
+    KMEANS_LOG_INFO("])");
 
-    printf("rings_upper_bounds = np.array([\n");
+    KMEANS_LOG_INFO("rings_upper_bounds = np.array([");
     for (size_t c = 0; c < k; c++)
     {
-        printf("  [");
+        line.str("");
+        line << "  [";
         for (int l = rings->RangeStart; l <= rings->RangeEnd; l++)
         {
             auto ring = rings->find(c, l);
-            printf("%0.5f, ", ring->getUpperBoundCost());
+            line << ring->getUpperBoundCost() << ", ";
         }
-        printf("],\n");
+        line << "],";
+        KMEANS_LOG_INFO("%s", line.str().c_str());
     }
-    printf("])\n");
+    KMEANS_LOG_INFO("])");
 }
+
+template std::shared_ptr<Coreset> GroupSampling::run(const blaze::DynamicMatrix<float> &);
+template std::shared_ptr<Coreset> GroupSampling::run(const blaze::DynamicMatrix<double> &);
@@ -6,13 +6,20 @@ SensitivitySampling::SensitivitySampling(size_t numberOfClusters, size_t targetS
 {
 }
 
+template <typename T>
 std::shared_ptr<Coreset>
-SensitivitySampling::run(const blaze::DynamicMatrix<double> &data)
+SensitivitySampling::run(const blaze::DynamicMatrix<T> &data)
 {
     clustering::KMeans kMeansAlg(NumberOfClusters);
+    kMeansAlg.enableCheckpoints(this->checkpointPath, this->checkpointInterval);
 
     auto result = kMeansAlg.run(data);
+    return run(result);
+}
 
+std::shared_ptr<Coreset>
+SensitivitySampling::run(const std::shared_ptr<clustering::ClusteringResult> result)
+{
     auto clusterAssignments = result->getClusterAssignments();
 
     auto coreset = generateCoresetPoints(clusterAssignments);
@@ -20,6 +27,13 @@ SensitivitySampling::run(const blaze::DynamicMatrix<double> &data)
     return coreset;
 }
 
+void
+SensitivitySampling::enableCheckpoints(const std::string &filePath, size_t interval)
+{
+    this->checkpointPath = filePath;
+    this->checkpointInterval = interval;
+}
+
 std::shared_ptr<Coreset>
 SensitivitySampling::generateCoresetPoints(const clustering::ClusterAssignmentList &clusterAssignments)
 {
@@ -34,8 +48,7 @@ SensitivitySampling::generateCoresetPoints(const clustering::ClusterAssignmentLi
 
     // TODO: Investigate why small weights generate samples that are all zeros.
     auto sampledIndices = random.choice(TargetSamplesInCoreset, n, samplingDistribution * 100);
-    std::cout << "Sampled T points: \n"
-              << (*sampledIndices) << "\n";
+    KMEANS_LOG_TRACE("Sampled T points:\n%s", utils::toString(*sampledIndices).c_str());
 
     // Loop through the sampled points and calculate
     // the weight associated with each of these points.
@@ -51,7 +64,7 @@ SensitivitySampling::generateCoresetPoints(const clustering::ClusterAssignmentLi
 
         coreset->addPoint(sampledPointIndex, weight);
 
-        printf("Sampled point %3ld gets weight %.5f \n", sampledPointIndex, weight);
+        KMEANS_LOG_TRACE("Sampled point %3ld gets weight %.5f", sampledPointIndex, weight);
     }
 
     auto numberOfClusters = clusterAssignments.getNumberOfClusters();
@@ -90,16 +103,12 @@ SensitivitySampling::calcCenterWeights(
         // Compute cost(A)/(T*cost(p,A))
         double weightContributionOfP = sumOfCosts / (TargetSamplesInCoreset * costPOfA);
 
-        printf("Point %3ld contributes %.5f to cluster %ld  ", p, weightContributionOfP, clusterOfPointP);
-
         // Sum it up: sum_{p sampled and p in C_i}   cost(A)/(T*cost(p,A))
         (*centerWeights)[clusterOfPointP] += weightContributionOfP;
 
-        printf("  =>  w_%ld = %.5f\n", clusterOfPointP, (*centerWeights)[clusterOfPointP]);
+        KMEANS_LOG_TRACE("Point %3ld contributes %.5f to cluster %ld    =>  w_%ld = %.5f", p, weightContributionOfP, clusterOfPointP, clusterOfPointP, (*centerWeights)[clusterOfPointP]);
     }
 
-    printf("\n\n");
-
     // For each of the k' centers, compute the center weights.
     for (size_t c = 0; c < numberOfClusters; c++)
     {
@@ -115,8 +124,11 @@ SensitivitySampling::calcCenterWeights(
         // Update the center weight.
         (*centerWeights)[c] = centerWeight;
 
-        printf("|C_%ld| = %3ld,  w_%ld = %2.5f,  new w_%ld = %2.5f \n", c, numberOfPointsInCluster, c, w_i, c, centerWeight);
+        KMEANS_LOG_DEBUG("|C_%ld| = %3ld,  w_%ld = %2.5f,  new w_%ld = %2.5f", c, numberOfPointsInCluster, c, w_i, c, centerWeight);
     }
 
     return centerWeights;
 }
+
+template std::shared_ptr<Coreset> SensitivitySampling::run(const blaze::DynamicMatrix<float> &);
+template std::shared_ptr<Coreset> SensitivitySampling::run(const blaze::DynamicMatrix<double> &);
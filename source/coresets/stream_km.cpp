@@ -6,15 +6,23 @@ StreamKMeans::StreamKMeans(size_t targetSamplesInCoreset) : TargetSamplesInCores
 {
 }
 
+template <typename T>
 std::shared_ptr<Coreset>
-StreamKMeans::run(const blaze::DynamicMatrix<double> &data)
+StreamKMeans::run(const blaze::DynamicMatrix<T> &data)
 {
-    auto coreset = std::make_shared<Coreset>(TargetSamplesInCoreset);
-
-    // Run k-Means++ where k=T where T is the number of points to be included in the coreset
-    clustering::KMeans kMeansAlg(TargetSamplesInCoreset);
+    // Run k-Means++ where k=T where T is the number of points to be included in the coreset.
+    // Since T is large, use Yinyang's group filtering to avoid computing most of the N*T distances.
+    clustering::KMeans kMeansAlg(TargetSamplesInCoreset, true, false, 100, 0.0001, clustering::AssignmentMode::Yinyang);
+    kMeansAlg.enableCheckpoints(this->checkpointPath, this->checkpointInterval);
 
     auto result = kMeansAlg.run(data);
+    return run(result);
+}
+
+std::shared_ptr<Coreset>
+StreamKMeans::run(const std::shared_ptr<clustering::ClusteringResult> result)
+{
+    auto coreset = std::make_shared<Coreset>(TargetSamplesInCoreset);
 
     auto clusterAssignments = result->getClusterAssignments();
 
@@ -27,3 +35,13 @@ StreamKMeans::run(const blaze::DynamicMatrix<double> &data)
     
     return coreset;
 }
+
+void
+StreamKMeans::enableCheckpoints(const std::string &filePath, size_t interval)
+{
+    this->checkpointPath = filePath;
+    this->checkpointInterval = interval;
+}
+
+template std::shared_ptr<Coreset> StreamKMeans::run(const blaze::DynamicMatrix<float> &);
+template std::shared_ptr<Coreset> StreamKMeans::run(const blaze::DynamicMatrix<double> &);
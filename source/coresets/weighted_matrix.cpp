@@ -0,0 +1,135 @@
+#include <coresets/weighted_matrix.hpp>
+
+using namespace coresets;
+
+namespace
+{
+    /**
+     * Identifies materialised coresets and the version of their format.
+     */
+    const char WeightedMatrixMagic[8] = {'K', 'M', 'C', 'O', 'R', 'E', 'S', '1'};
+
+    void
+    writeInteger(std::ostream &stream, uint64_t value)
+    {
+        stream.write(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+
+    uint64_t
+    readInteger(std::istream &stream)
+    {
+        uint64_t value = 0;
+        if (!stream.read(reinterpret_cast<char *>(&value), sizeof(value)))
+        {
+            throw std::runtime_error("Unexpected end of weighted matrix.");
+        }
+        return value;
+    }
+}
+
+template <typename T>
+WeightedMatrix<T>::WeightedMatrix(blaze::DynamicMatrix<T> pointsToStore, blaze::DynamicVector<double> weightsToStore) : points(std::move(pointsToStore)), weights(std::move(weightsToStore))
+{
+    if (points.rows() != weights.size())
+    {
+        throw std::invalid_argument("There must be one weight for each point.");
+    }
+}
+
+template <typename T>
+const blaze::DynamicMatrix<T> &
+WeightedMatrix<T>::getPoints() const
+{
+    return points;
+}
+
+template <typename T>
+const blaze::DynamicVector<double> &
+WeightedMatrix<T>::getWeights() const
+{
+    return weights;
+}
+
+template <typename T>
+size_t
+WeightedMatrix<T>::size() const
+{
+    return points.rows();
+}
+
+template <typename T>
+void
+WeightedMatrix<T>::save(std::ostream &stream) const
+{
+    const size_t n = points.rows();
+    const size_t d = points.columns();
+
+    stream.write(WeightedMatrixMagic, sizeof(WeightedMatrixMagic));
+    writeInteger(stream, n);
+    writeInteger(stream, d);
+    writeInteger(stream, sizeof(T));
+
+    std::vector<double> weightValues(weights.begin(), weights.end());
+    stream.write(reinterpret_cast<const char *>(weightValues.data()), static_cast<std::streamsize>(n * sizeof(double)));
+
+    // Rows of a Blaze matrix may be padded, so the values are copied row by row.
+    std::vector<T> row(d);
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t j = 0; j < d; j++)
+        {
+            row[j] = points(i, j);
+        }
+        stream.write(reinterpret_cast<const char *>(row.data()), static_cast<std::streamsize>(d * sizeof(T)));
+    }
+}
+
+template <typename T>
+std::shared_ptr<WeightedMatrix<T>>
+WeightedMatrix<T>::load(std::istream &stream)
+{
+    char magic[sizeof(WeightedMatrixMagic)];
+    if (!stream.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), WeightedMatrixMagic))
+    {
+        throw std::runtime_error("The stream does not contain a weighted matrix.");
+    }
+
+    const auto n = readInteger(stream);
+    const auto d = readInteger(stream);
+    if (readInteger(stream) != sizeof(T))
+    {
+        throw std::runtime_error("The weighted matrix was written with a different scalar type.");
+    }
+
+    std::vector<double> weightValues(n);
+    if (!stream.read(reinterpret_cast<char *>(weightValues.data()), static_cast<std::streamsize>(n * sizeof(double))))
+    {
+        throw std::runtime_error("Unexpected end of weighted matrix.");
+    }
+
+    blaze::DynamicVector<double> loadedWeights(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        loadedWeights[i] = weightValues[i];
+    }
+
+    blaze::DynamicMatrix<T> loadedPoints(n, d);
+    std::vector<T> row(d);
+    for (size_t i = 0; i < n; i++)
+    {
+        if (!stream.read(reinterpret_cast<char *>(row.data()), static_cast<std::streamsize>(d * sizeof(T))))
+        {
+            throw std::runtime_error("Unexpected end of weighted matrix.");
+        }
+
+        for (size_t j = 0; j < d; j++)
+        {
+            loadedPoints(i, j) = row[j];
+        }
+    }
+
+    return std::make_shared<WeightedMatrix<T>>(std::move(loadedPoints), std::move(loadedWeights));
+}
+
+template class coresets::WeightedMatrix<float>;
+template class coresets::WeightedMatrix<double>;
@@ -0,0 +1,175 @@
+#include <data/block_file.hpp>
+
+using namespace data;
+
+namespace
+{
+    /**
+     * Identifies block files and the version of their format.
+     */
+    const char BlockFileMagic[8] = {'K', 'M', 'B', 'L', 'O', 'C', 'K', '1'};
+
+    /**
+     * The header holds the magic, the number of rows, the number of columns and the scalar size.
+     */
+    const size_t BlockFileHeaderSize = sizeof(BlockFileMagic) + 3 * sizeof(uint64_t);
+
+    void
+    writeHeader(std::ofstream &file, uint64_t numOfRows, uint64_t numOfColumns, uint64_t scalarSize)
+    {
+        file.write(BlockFileMagic, sizeof(BlockFileMagic));
+        file.write(reinterpret_cast<const char *>(&numOfRows), sizeof(numOfRows));
+        file.write(reinterpret_cast<const char *>(&numOfColumns), sizeof(numOfColumns));
+        file.write(reinterpret_cast<const char *>(&scalarSize), sizeof(scalarSize));
+    }
+}
+
+template <typename T>
+BlockFileWriter<T>::BlockFileWriter(const std::string &filePath, size_t numOfColumns) : NumOfColumns(numOfColumns),
+                                                                                         file(filePath, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc)
+{
+    if (!file)
+    {
+        throw std::runtime_error("Cannot create block file " + filePath);
+    }
+
+    // The number of rows is written when the file is closed.
+    writeHeader(file, 0, NumOfColumns, sizeof(T));
+}
+
+template <typename T>
+BlockFileWriter<T>::~BlockFileWriter()
+{
+    if (file.is_open())
+    {
+        try
+        {
+            close();
+        }
+        catch (const std::runtime_error &)
+        {
+            // Destructors must not throw, call `close` to handle write errors.
+        }
+    }
+}
+
+template <typename T>
+void
+BlockFileWriter<T>::appendRow(const std::vector<T> &values)
+{
+    if (values.size() != NumOfColumns)
+    {
+        throw std::invalid_argument("The row does not have the number of columns of the block file.");
+    }
+
+    file.write(reinterpret_cast<const char *>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+    numOfRows++;
+}
+
+template <typename T>
+void
+BlockFileWriter<T>::appendRows(const blaze::DynamicMatrix<T> &rows)
+{
+    if (rows.columns() != NumOfColumns)
+    {
+        throw std::invalid_argument("The rows do not have the number of columns of the block file.");
+    }
+
+    // Rows of a Blaze matrix may be padded, so the values are copied row by row.
+    buffer.resize(NumOfColumns);
+    for (size_t i = 0; i < rows.rows(); i++)
+    {
+        for (size_t j = 0; j < NumOfColumns; j++)
+        {
+            buffer[j] = rows(i, j);
+        }
+        appendRow(buffer);
+    }
+}
+
+template <typename T>
+void
+BlockFileWriter<T>::close()
+{
+    file.seekp(0);
+    writeHeader(file, numOfRows, NumOfColumns, sizeof(T));
+    file.close();
+
+    if (!file)
+    {
+        throw std::runtime_error("Failed to write the block file.");
+    }
+}
+
+template <typename T>
+size_t
+BlockFileWriter<T>::getNumberOfRows() const
+{
+    return numOfRows;
+}
+
+template <typename T>
+BlockFileReader<T>::BlockFileReader(const std::string &filePath) : file(filePath, std::ios_base::in | std::ios_base::binary)
+{
+    char magic[sizeof(BlockFileMagic)];
+    uint64_t header[3];
+    if (!file.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), BlockFileMagic) ||
+        !file.read(reinterpret_cast<char *>(header), sizeof(header)))
+    {
+        throw std::runtime_error(filePath + " is not a block file.");
+    }
+
+    if (header[2] != sizeof(T))
+    {
+        throw std::runtime_error("The values in " + filePath + " have a different scalar type.");
+    }
+
+    numOfRows = header[0];
+    numOfColumns = header[1];
+}
+
+template <typename T>
+size_t
+BlockFileReader<T>::getNumberOfRows() const
+{
+    return numOfRows;
+}
+
+template <typename T>
+size_t
+BlockFileReader<T>::getNumberOfColumns() const
+{
+    return numOfColumns;
+}
+
+template <typename T>
+void
+BlockFileReader<T>::readRows(size_t firstRow, size_t numOfRowsToRead, blaze::DynamicMatrix<T> &block)
+{
+    if (firstRow + numOfRowsToRead > numOfRows)
+    {
+        throw std::out_of_range("The rows to read are beyond the end of the block file.");
+    }
+
+    buffer.resize(numOfRowsToRead * numOfColumns);
+    file.seekg(static_cast<std::streamoff>(BlockFileHeaderSize + firstRow * numOfColumns * sizeof(T)));
+    if (!file.read(reinterpret_cast<char *>(buffer.data()), static_cast<std::streamsize>(buffer.size() * sizeof(T))))
+    {
+        throw std::runtime_error("Failed to read rows from the block file.");
+    }
+
+    // Keep the allocation of the block when it has the same size as the previous one.
+    block.resize(numOfRowsToRead, numOfColumns, false);
+    for (size_t i = 0; i < numOfRowsToRead; i++)
+    {
+        for (size_t j = 0; j < numOfColumns; j++)
+        {
+            block(i, j) = buffer[i * numOfColumns + j];
+        }
+    }
+}
+
+template class data::BlockFileWriter<float>;
+template class data::BlockFileWriter<double>;
+template class data::BlockFileReader<float>;
+template class data::BlockFileReader<double>;
@@ -3,10 +3,12 @@
 using namespace data;
 namespace io = boost::iostreams;
 
-std::shared_ptr<blaze::DynamicMatrix<double>>
-BagOfWordsParser::parse(const std::string &filePath)
+template <typename T>
+template <typename SizeCallback, typename EntryCallback>
+void
+BagOfWordsParser<T>::readEntries(const std::string &filePath, SizeCallback onSize, EntryCallback onEntry)
 {
-    printf("Opening input file %s...\n", filePath.c_str());
+    KMEANS_LOG_INFO("Opening input file %s...", filePath.c_str());
 
     std::ifstream fileStream(filePath, std::ios_base::in | std::ios_base::binary);
     io::filtering_streambuf<io::input> filteredInputStream;
@@ -34,17 +36,16 @@ BagOfWordsParser::parse(const std::string &filePath)
     auto dataSize = std::stoul(line.c_str());
     std::getline(inData, line); // Read line with W
     auto dimSize = std::stoul(line.c_str());
-    std::getline(inData, line); // Skip line with NNZ
+    std::getline(inData, line); // Read line with NNZ
+    auto nonZeros = std::stoul(line.c_str());
 
-    printf("Data size: %ld, vocabulary size: %ld\n", dataSize, dimSize);
+    KMEANS_LOG_INFO("Data size: %ld, vocabulary size: %ld", dataSize, dimSize);
+    onSize(dataSize, dimSize, nonZeros);
 
     bool firstDataLine = true;
     size_t previousDocId = 0, currentRow = 0, docId = 0, wordId = 0;
     size_t lineNo = 3;
-    double count;
-
-    auto data = std::make_shared<blaze::DynamicMatrix<double>>(dataSize, dimSize);
-    data->reset();
+    T count;
 
     while (inData.good())
     {
@@ -56,13 +57,13 @@ BagOfWordsParser::parse(const std::string &filePath)
 
         if (splits.size() != 3)
         {
-            printf("Skipping line no %ld: '%s'.\n", lineNo, line.c_str());
+            KMEANS_LOG_WARNING("Skipping line no %ld: '%s'.", lineNo, line.c_str());
             continue;
         }
 
         docId = std::stoul(splits[0]);
         wordId = std::stoul(splits[1]) - 1; // Convert to zero-based array indexing
-        count = static_cast<double>(std::stoul(splits[2]));
+        count = static_cast<T>(std::stoul(splits[2]));
 
         if (firstDataLine)
         {
@@ -75,10 +76,79 @@ BagOfWordsParser::parse(const std::string &filePath)
             currentRow++;
         }
 
-        data->at(currentRow, wordId) = count;
+        onEntry(currentRow, wordId, count);
 
         previousDocId = docId;
     }
+}
+
+template <typename T>
+std::shared_ptr<blaze::DynamicMatrix<T>>
+BagOfWordsParser<T>::parse(const std::string &filePath)
+{
+    std::shared_ptr<blaze::DynamicMatrix<T>> data;
+
+    readEntries(
+        filePath,
+        [&](size_t dataSize, size_t dimSize, size_t /*nonZeros*/)
+        {
+            data = std::make_shared<blaze::DynamicMatrix<T>>(dataSize, dimSize);
+            data->reset();
+        },
+        [&](size_t row, size_t wordId, T count)
+        { data->at(row, wordId) = count; });
 
     return data;
-}
\ No newline at end of file
+}
+
+template <typename T>
+std::shared_ptr<blaze::CompressedMatrix<T>>
+BagOfWordsParser<T>::parseSparse(const std::string &filePath)
+{
+    std::shared_ptr<blaze::CompressedMatrix<T>> data;
+
+    // The rows are filled in order with append() which is O(1) per entry, but the words of a row
+    // must be appended in increasing order, so the entries of the current row are buffered.
+    std::vector<std::pair<size_t, T>> rowEntries;
+    size_t nextRow = 0;
+
+    auto finaliseRow = [&]()
+    {
+        std::sort(rowEntries.begin(), rowEntries.end(), [](const auto &a, const auto &b)
+                  { return a.first < b.first; });
+        for (auto &&entry : rowEntries)
+        {
+            data->append(nextRow, entry.first, entry.second);
+        }
+        data->finalize(nextRow);
+        rowEntries.clear();
+        nextRow++;
+    };
+
+    readEntries(
+        filePath,
+        [&](size_t dataSize, size_t dimSize, size_t nonZeros)
+        {
+            data = std::make_shared<blaze::CompressedMatrix<T>>(dataSize, dimSize);
+            data->reserve(nonZeros);
+        },
+        [&](size_t row, size_t wordId, T count)
+        {
+            while (nextRow < row)
+            {
+                finaliseRow();
+            }
+            rowEntries.emplace_back(wordId, count);
+        });
+
+    // Finalise the last row and any trailing rows without entries.
+    while (data != nullptr && nextRow < data->rows())
+    {
+        finaliseRow();
+    }
+
+    return data;
+}
+
+template class data::BagOfWordsParser<float>;
+template class data::BagOfWordsParser<double>;
@@ -3,10 +3,12 @@
 using namespace data;
 namespace io = boost::iostreams;
 
-std::shared_ptr<blaze::DynamicMatrix<double>>
-CensusParser::parse(const std::string &filePath)
+template <typename T>
+template <typename SizeCallback, typename RowCallback>
+void
+CensusParser<T>::readRows(const std::string &filePath, SizeCallback onSize, RowCallback onRow)
 {
-    printf("Opening input file %s...\n", filePath.c_str());
+    KMEANS_LOG_INFO("Opening input file %s...", filePath.c_str());
 
     std::ifstream fileStream(filePath, std::ios_base::in | std::ios_base::binary);
     io::filtering_streambuf<io::input> filteredInputStream;
@@ -20,18 +22,16 @@ CensusParser::parse(const std::string &filePath)
     std::string line;
 
     std::getline(inData, line); // Ignore the header line.
-    printf("Preparing Census Dataset. Skip first line: %s\n", line.c_str());
+    KMEANS_LOG_INFO("Preparing Census Dataset. Skip first line: %s", line.c_str());
 
     auto dimSize = 68UL;
     auto dataSize = 2458285UL;
 
-    printf("Data size: %ld, Dimensions: %ld\n", dataSize, dimSize);
+    KMEANS_LOG_INFO("Data size: %ld, Dimensions: %ld", dataSize, dimSize);
+    onSize(dataSize, dimSize);
 
-    size_t currentRow = 0;
     size_t lineNo = 3;
-
-    auto data = std::make_shared<blaze::DynamicMatrix<double>>(dataSize, dimSize);
-    data->reset();
+    std::vector<T> row(dimSize);
 
     while (inData.good())
     {
@@ -43,18 +43,62 @@ CensusParser::parse(const std::string &filePath)
 
         if (splits.size() != dimSize+1)
         {
-            printf("Skipping line no %ld: expected %ld values but got %ld.\n", lineNo, dimSize+1, splits.size());
+            KMEANS_LOG_WARNING("Skipping line no %ld: expected %ld values but got %ld.", lineNo, dimSize+1, splits.size());
             continue;
         }
 
         for (size_t j = 0; j < dimSize; j++)
         {
             // Skip the first attribute `caseid`
-            data->at(currentRow, j) = atof(splits[j+1].c_str());
+            row[j] = static_cast<T>(atof(splits[j+1].c_str()));
         }
 
-        currentRow++;
+        onRow(row);
     }
+}
+
+template <typename T>
+std::shared_ptr<blaze::DynamicMatrix<T>>
+CensusParser<T>::parse(const std::string &filePath)
+{
+    std::shared_ptr<blaze::DynamicMatrix<T>> data;
+    size_t currentRow = 0;
+
+    readRows(
+        filePath,
+        [&](size_t dataSize, size_t dimSize)
+        {
+            data = std::make_shared<blaze::DynamicMatrix<T>>(dataSize, dimSize);
+            data->reset();
+        },
+        [&](const std::vector<T> &row)
+        {
+            for (size_t j = 0; j < row.size(); j++)
+            {
+                data->at(currentRow, j) = row[j];
+            }
+            currentRow++;
+        });
 
     return data;
 }
+
+template <typename T>
+size_t
+CensusParser<T>::convertToBlockFile(const std::string &filePath, const std::string &blockFilePath)
+{
+    std::unique_ptr<BlockFileWriter<T>> writer;
+
+    readRows(
+        filePath,
+        [&](size_t /*dataSize*/, size_t dimSize)
+        { writer = std::make_unique<BlockFileWriter<T>>(blockFilePath, dimSize); },
+        [&](const std::vector<T> &row)
+        { writer->appendRow(row); });
+
+    writer->close();
+    return writer->getNumberOfRows();
+}
+
+template class data::CensusParser<float>;
+template class data::CensusParser<double>;
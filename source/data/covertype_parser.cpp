@@ -3,10 +3,12 @@
 using namespace data;
 namespace io = boost::iostreams;
 
-std::shared_ptr<blaze::DynamicMatrix<double>>
-CovertypeParser::parse(const std::string &filePath)
+template <typename T>
+template <typename SizeCallback, typename RowCallback>
+void
+CovertypeParser<T>::readRows(const std::string &filePath, SizeCallback onSize, RowCallback onRow)
 {
-    printf("Opening input file %s...\n", filePath.c_str());
+    KMEANS_LOG_INFO("Opening input file %s...", filePath.c_str());
 
     std::ifstream fileStream(filePath, std::ios_base::in | std::ios_base::binary);
     io::filtering_streambuf<io::input> filteredInputStream;
@@ -17,16 +19,15 @@ CovertypeParser::parse(const std::string &filePath)
     filteredInputStream.push(fileStream);
     std::istream inData(&filteredInputStream);
 
-    printf("Preparing Covertype dataset.\n");
+    KMEANS_LOG_INFO("Preparing Covertype dataset.");
 
     auto dimSize = 54UL;
     auto dataSize = 581012UL;
-    printf("Data size: %ld, Dimensions: %ld\n", dataSize, dimSize);
+    KMEANS_LOG_INFO("Data size: %ld, Dimensions: %ld", dataSize, dimSize);
+    onSize(dataSize, dimSize);
 
-    auto data = std::make_shared<blaze::DynamicMatrix<double>>(dataSize, dimSize);
-    data->reset();
-    
-    size_t lineNo = 0, currentRow = 0;
+    size_t lineNo = 0;
+    std::vector<T> row(dimSize);
 
     while (inData.good())
     {
@@ -39,7 +40,7 @@ CovertypeParser::parse(const std::string &filePath)
 
         if (splits.size() != dimSize + 1)
         {
-            printf("Skipping line no %ld: expected %ld values but got %ld.\n", lineNo, dimSize+1, splits.size());
+            KMEANS_LOG_WARNING("Skipping line no %ld: expected %ld values but got %ld.", lineNo, dimSize+1, splits.size());
             continue;
         }
 
@@ -48,11 +49,55 @@ CovertypeParser::parse(const std::string &filePath)
         // attribute so in total they had 54 attributes.
         for (size_t j = 0; j < dimSize; j++)
         {
-            data->at(currentRow, j) = atof(splits[j].c_str());
+            row[j] = static_cast<T>(atof(splits[j].c_str()));
         }
 
-        currentRow++;
+        onRow(row);
     }
+}
+
+template <typename T>
+std::shared_ptr<blaze::DynamicMatrix<T>>
+CovertypeParser<T>::parse(const std::string &filePath)
+{
+    std::shared_ptr<blaze::DynamicMatrix<T>> data;
+    size_t currentRow = 0;
+
+    readRows(
+        filePath,
+        [&](size_t dataSize, size_t dimSize)
+        {
+            data = std::make_shared<blaze::DynamicMatrix<T>>(dataSize, dimSize);
+            data->reset();
+        },
+        [&](const std::vector<T> &row)
+        {
+            for (size_t j = 0; j < row.size(); j++)
+            {
+                data->at(currentRow, j) = row[j];
+            }
+            currentRow++;
+        });
 
     return data;
 }
+
+template <typename T>
+size_t
+CovertypeParser<T>::convertToBlockFile(const std::string &filePath, const std::string &blockFilePath)
+{
+    std::unique_ptr<BlockFileWriter<T>> writer;
+
+    readRows(
+        filePath,
+        [&](size_t /*dataSize*/, size_t dimSize)
+        { writer = std::make_unique<BlockFileWriter<T>>(blockFilePath, dimSize); },
+        [&](const std::vector<T> &row)
+        { writer->appendRow(row); });
+
+    writer->close();
+    return writer->getNumberOfRows();
+}
+
+template class data::CovertypeParser<float>;
+template class data::CovertypeParser<double>;
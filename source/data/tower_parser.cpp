@@ -3,10 +3,12 @@
 using namespace data;
 namespace io = boost::iostreams;
 
-std::shared_ptr<blaze::DynamicMatrix<double>>
-TowerParser::parse(const std::string &filePath)
+template <typename T>
+template <typename SizeCallback, typename RowCallback>
+void
+TowerParser<T>::readRows(const std::string &filePath, SizeCallback onSize, RowCallback onRow)
 {
-    printf("Opening input file %s...\n", filePath.c_str());
+    KMEANS_LOG_INFO("Opening input file %s...", filePath.c_str());
 
     std::ifstream fileStream(filePath, std::ios_base::in | std::ios_base::binary);
     io::filtering_streambuf<io::input> filteredInputStream;
@@ -17,16 +19,15 @@ TowerParser::parse(const std::string &filePath)
     filteredInputStream.push(fileStream);
     std::istream inData(&filteredInputStream);
 
-    printf("Preparing Tower dataset.\n");
+    KMEANS_LOG_INFO("Preparing Tower dataset.");
 
     auto dimSize = 3UL;
     auto dataSize = 4915200UL;
-    printf("Data size: %ld, Dimensions: %ld\n", dataSize, dimSize);
+    KMEANS_LOG_INFO("Data size: %ld, Dimensions: %ld", dataSize, dimSize);
+    onSize(dataSize, dimSize);
 
-    auto data = std::make_shared<blaze::DynamicMatrix<double>>(dataSize, dimSize);
-    data->reset();
-
-    size_t lineNo = 0, currentRow = 0;
+    size_t lineNo = 0;
+    std::vector<T> row(dimSize);
 
     while (inData.good())
     {
@@ -35,11 +36,55 @@ TowerParser::parse(const std::string &filePath)
             std::string line;
             std::getline(inData, line);
             lineNo++;
-            data->at(currentRow, j) = static_cast<double>(std::stol(line));
+            row[j] = static_cast<T>(std::stol(line));
         }
-        
-        currentRow++;
+
+        onRow(row);
     }
+}
+
+template <typename T>
+std::shared_ptr<blaze::DynamicMatrix<T>>
+TowerParser<T>::parse(const std::string &filePath)
+{
+    std::shared_ptr<blaze::DynamicMatrix<T>> data;
+    size_t currentRow = 0;
+
+    readRows(
+        filePath,
+        [&](size_t dataSize, size_t dimSize)
+        {
+            data = std::make_shared<blaze::DynamicMatrix<T>>(dataSize, dimSize);
+            data->reset();
+        },
+        [&](const std::vector<T> &row)
+        {
+            for (size_t j = 0; j < row.size(); j++)
+            {
+                data->at(currentRow, j) = row[j];
+            }
+            currentRow++;
+        });
 
     return data;
 }
+
+template <typename T>
+size_t
+TowerParser<T>::convertToBlockFile(const std::string &filePath, const std::string &blockFilePath)
+{
+    std::unique_ptr<BlockFileWriter<T>> writer;
+
+    readRows(
+        filePath,
+        [&](size_t /*dataSize*/, size_t dimSize)
+        { writer = std::make_unique<BlockFileWriter<T>>(blockFilePath, dimSize); },
+        [&](const std::vector<T> &row)
+        { writer->appendRow(row); });
+
+    writer->close();
+    return writer->getNumberOfRows();
+}
+
+template class data::TowerParser<float>;
+template class data::TowerParser<double>;
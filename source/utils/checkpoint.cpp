@@ -0,0 +1,442 @@
+#include <utils/checkpoint.hpp>
+
+using namespace utils;
+
+namespace
+{
+    /**
+     * Identifies checkpoint files and the version of their format.
+     */
+    const char CheckpointMagic[8] = {'K', 'M', 'C', 'K', 'P', 'T', '0', '1'};
+
+    void
+    writeInteger(std::ostream &stream, uint64_t value)
+    {
+        stream.write(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+
+    uint64_t
+    readInteger(std::istream &stream)
+    {
+        uint64_t value = 0;
+        if (!stream.read(reinterpret_cast<char *>(&value), sizeof(value)))
+        {
+            throw std::runtime_error("Unexpected end of checkpoint.");
+        }
+        return value;
+    }
+
+    void
+    writeBytes(std::ostream &stream, const std::string &bytes)
+    {
+        writeInteger(stream, bytes.size());
+        stream.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    std::string
+    readBytes(std::istream &stream)
+    {
+        const auto size = readInteger(stream);
+        std::string bytes(size, '\0');
+        if (size > 0 && !stream.read(&bytes[0], static_cast<std::streamsize>(size)))
+        {
+            throw std::runtime_error("Unexpected end of checkpoint.");
+        }
+        return bytes;
+    }
+
+    /**
+     * Offset basis and prime of the 64-bit FNV-1a hash, which is applied to whole values instead of bytes.
+     */
+    const uint64_t FingerprintBasis = 14695981039346656037ULL;
+    const uint64_t FingerprintPrime = 1099511628211ULL;
+
+    template <typename V>
+    inline void
+    addToFingerprint(uint64_t &fingerprint, V value)
+    {
+        static_assert(sizeof(V) <= sizeof(uint64_t), "Values must fit into 64 bits.");
+        uint64_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(V));
+        fingerprint = (fingerprint ^ bits) * FingerprintPrime;
+    }
+}
+
+void
+Checkpoint::setEntry(const std::string &name, ValueType type, uint64_t rows, uint64_t columns, const void *data, size_t numOfBytes)
+{
+    Entry entry;
+    entry.Type = type;
+    entry.Rows = rows;
+    entry.Columns = columns;
+    entry.Bytes.assign(static_cast<const char *>(data), numOfBytes);
+    entries[name] = std::move(entry);
+}
+
+const Checkpoint::Entry &
+Checkpoint::getEntry(const std::string &name, ValueType type) const
+{
+    auto it = entries.find(name);
+    if (it == entries.end() || it->second.Type != type)
+    {
+        throw std::out_of_range("Checkpoint does not contain the value '" + name + "'.");
+    }
+    return it->second;
+}
+
+void
+Checkpoint::setMatrix(const std::string &name, const blaze::DynamicMatrix<double> &value)
+{
+    // Rows of a Blaze matrix may be padded, so the elements are copied row by row.
+    std::vector<double> elements(value.rows() * value.columns());
+    for (size_t i = 0; i < value.rows(); i++)
+    {
+        for (size_t j = 0; j < value.columns(); j++)
+        {
+            elements[i * value.columns() + j] = value(i, j);
+        }
+    }
+    setEntry(name, ValueType::Matrix, value.rows(), value.columns(), elements.data(), elements.size() * sizeof(double));
+}
+
+void
+Checkpoint::setVector(const std::string &name, const blaze::DynamicVector<double> &value)
+{
+    std::vector<double> elements(value.begin(), value.end());
+    setEntry(name, ValueType::Vector, value.size(), 1, elements.data(), elements.size() * sizeof(double));
+}
+
+void
+Checkpoint::setIndices(const std::string &name, const std::vector<size_t> &value)
+{
+    std::vector<uint64_t> elements(value.begin(), value.end());
+    setEntry(name, ValueType::Indices, value.size(), 1, elements.data(), elements.size() * sizeof(uint64_t));
+}
+
+void
+Checkpoint::setInteger(const std::string &name, size_t value)
+{
+    const uint64_t element = value;
+    setEntry(name, ValueType::Integer, 1, 1, &element, sizeof(element));
+}
+
+void
+Checkpoint::setReal(const std::string &name, double value)
+{
+    setEntry(name, ValueType::Real, 1, 1, &value, sizeof(value));
+}
+
+void
+Checkpoint::setText(const std::string &name, const std::string &value)
+{
+    setEntry(name, ValueType::Text, value.size(), 1, value.data(), value.size());
+}
+
+blaze::DynamicMatrix<double>
+Checkpoint::getMatrix(const std::string &name) const
+{
+    const auto &entry = getEntry(name, ValueType::Matrix);
+    const auto *elements = reinterpret_cast<const double *>(entry.Bytes.data());
+
+    blaze::DynamicMatrix<double> value(entry.Rows, entry.Columns);
+    for (size_t i = 0; i < entry.Rows; i++)
+    {
+        for (size_t j = 0; j < entry.Columns; j++)
+        {
+            value(i, j) = elements[i * entry.Columns + j];
+        }
+    }
+    return value;
+}
+
+blaze::DynamicVector<double>
+Checkpoint::getVector(const std::string &name) const
+{
+    const auto &entry = getEntry(name, ValueType::Vector);
+    const auto *elements = reinterpret_cast<const double *>(entry.Bytes.data());
+
+    blaze::DynamicVector<double> value(entry.Rows);
+    for (size_t i = 0; i < entry.Rows; i++)
+    {
+        value[i] = elements[i];
+    }
+    return value;
+}
+
+std::vector<size_t>
+Checkpoint::getIndices(const std::string &name) const
+{
+    const auto &entry = getEntry(name, ValueType::Indices);
+    const auto *elements = reinterpret_cast<const uint64_t *>(entry.Bytes.data());
+    return std::vector<size_t>(elements, elements + entry.Rows);
+}
+
+size_t
+Checkpoint::getInteger(const std::string &name) const
+{
+    const auto &entry = getEntry(name, ValueType::Integer);
+    return static_cast<size_t>(*reinterpret_cast<const uint64_t *>(entry.Bytes.data()));
+}
+
+double
+Checkpoint::getReal(const std::string &name) const
+{
+    const auto &entry = getEntry(name, ValueType::Real);
+    return *reinterpret_cast<const double *>(entry.Bytes.data());
+}
+
+std::string
+Checkpoint::getText(const std::string &name) const
+{
+    return getEntry(name, ValueType::Text).Bytes;
+}
+
+bool
+Checkpoint::contains(const std::string &name) const
+{
+    return entries.find(name) != entries.end();
+}
+
+void
+Checkpoint::setAll(const Checkpoint &other)
+{
+    for (const auto &entry : other.entries)
+    {
+        entries[entry.first] = entry.second;
+    }
+}
+
+bool
+Checkpoint::includes(const Checkpoint &other) const
+{
+    for (const auto &otherEntry : other.entries)
+    {
+        auto it = entries.find(otherEntry.first);
+        if (it == entries.end())
+        {
+            return false;
+        }
+
+        const auto &entry = it->second;
+        const auto &expected = otherEntry.second;
+        if (entry.Type != expected.Type || entry.Rows != expected.Rows || entry.Columns != expected.Columns || entry.Bytes != expected.Bytes)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+Checkpoint::save(std::ostream &stream) const
+{
+    stream.write(CheckpointMagic, sizeof(CheckpointMagic));
+    writeInteger(stream, entries.size());
+
+    for (auto &&item : entries)
+    {
+        const auto &entry = item.second;
+        writeBytes(stream, item.first);
+        writeInteger(stream, static_cast<uint64_t>(entry.Type));
+        writeInteger(stream, entry.Rows);
+        writeInteger(stream, entry.Columns);
+        writeBytes(stream, entry.Bytes);
+    }
+}
+
+std::shared_ptr<Checkpoint>
+Checkpoint::load(std::istream &stream)
+{
+    char magic[sizeof(CheckpointMagic)];
+    if (!stream.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), CheckpointMagic))
+    {
+        throw std::runtime_error("The stream does not contain a checkpoint.");
+    }
+
+    auto checkpoint = std::make_shared<Checkpoint>();
+    const auto numOfEntries = readInteger(stream);
+    for (uint64_t i = 0; i < numOfEntries; i++)
+    {
+        auto name = readBytes(stream);
+
+        Entry entry;
+        entry.Type = static_cast<ValueType>(readInteger(stream));
+        entry.Rows = readInteger(stream);
+        entry.Columns = readInteger(stream);
+        entry.Bytes = readBytes(stream);
+
+        const size_t elementSize = entry.Type == ValueType::Text ? 1 : 8;
+        if (entry.Bytes.size() != entry.Rows * entry.Columns * elementSize)
+        {
+            throw std::runtime_error("The size of the checkpoint value '" + name + "' does not match its shape.");
+        }
+
+        checkpoint->entries[name] = std::move(entry);
+    }
+
+    return checkpoint;
+}
+
+std::shared_ptr<Checkpoint>
+utils::readCheckpoint(const std::string &filePath)
+{
+    if (filePath.empty())
+    {
+        return nullptr;
+    }
+
+    std::ifstream file(filePath, std::ios_base::in | std::ios_base::binary);
+    if (!file)
+    {
+        return nullptr;
+    }
+
+    return Checkpoint::load(file);
+}
+
+void
+utils::removeCheckpoint(const std::string &filePath)
+{
+    if (filePath.empty())
+    {
+        return;
+    }
+
+    // The file may not exist, e.g., if no checkpoint was due before the algorithm completed.
+    std::remove(filePath.c_str());
+}
+
+template <typename T>
+size_t
+utils::calcFingerprint(const blaze::DynamicMatrix<T> &matrix)
+{
+    uint64_t fingerprint = FingerprintBasis;
+    addToFingerprint(fingerprint, matrix.rows());
+    addToFingerprint(fingerprint, matrix.columns());
+    for (size_t i = 0; i < matrix.rows(); i++)
+    {
+        for (size_t j = 0; j < matrix.columns(); j++)
+        {
+            addToFingerprint(fingerprint, matrix(i, j));
+        }
+    }
+    return fingerprint;
+}
+
+template <typename T>
+size_t
+utils::calcFingerprint(const blaze::CompressedMatrix<T> &matrix)
+{
+    uint64_t fingerprint = FingerprintBasis;
+    addToFingerprint(fingerprint, matrix.rows());
+    addToFingerprint(fingerprint, matrix.columns());
+    for (size_t i = 0; i < matrix.rows(); i++)
+    {
+        for (auto it = matrix.begin(i); it != matrix.end(i); ++it)
+        {
+            addToFingerprint(fingerprint, i);
+            addToFingerprint(fingerprint, it->index());
+            addToFingerprint(fingerprint, it->value());
+        }
+    }
+    return fingerprint;
+}
+
+size_t
+utils::calcFingerprint(const blaze::DynamicVector<double> &vector)
+{
+    uint64_t fingerprint = FingerprintBasis;
+    addToFingerprint(fingerprint, vector.size());
+    for (size_t i = 0; i < vector.size(); i++)
+    {
+        addToFingerprint(fingerprint, vector[i]);
+    }
+    return fingerprint;
+}
+
+CheckpointWriter::CheckpointWriter(const std::string &filePath) : FilePath(filePath)
+{
+    thread = std::thread(&CheckpointWriter::writeLoop, this);
+}
+
+CheckpointWriter::~CheckpointWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        isStopping = true;
+    }
+    changed.notify_all();
+    thread.join();
+}
+
+void
+CheckpointWriter::write(std::shared_ptr<const Checkpoint> checkpoint)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending = checkpoint;
+    }
+    changed.notify_all();
+}
+
+void
+CheckpointWriter::flush()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this]
+                 { return pending == nullptr && !isWriting; });
+}
+
+void
+CheckpointWriter::remove()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    pending = nullptr;
+    changed.wait(lock, [this]
+                 { return !isWriting; });
+    removeCheckpoint(FilePath);
+}
+
+void
+CheckpointWriter::writeLoop()
+{
+    const std::string temporaryPath = FilePath + ".tmp";
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        // The pending checkpoint is still written when stopping.
+        changed.wait(lock, [this]
+                     { return pending != nullptr || isStopping; });
+        if (pending == nullptr)
+        {
+            return;
+        }
+
+        auto checkpoint = pending;
+        pending = nullptr;
+        isWriting = true;
+        lock.unlock();
+
+        {
+            std::ofstream file(temporaryPath, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+            checkpoint->save(file);
+            file.close();
+
+            if (!file || std::rename(temporaryPath.c_str(), FilePath.c_str()) != 0)
+            {
+                // A failed checkpoint should not stop the algorithm, the previous checkpoint is kept.
+                KMEANS_LOG_ERROR("Failed to write checkpoint %s", FilePath.c_str());
+            }
+        }
+
+        lock.lock();
+        isWriting = false;
+        changed.notify_all();
+    }
+}
+
+template size_t utils::calcFingerprint(const blaze::DynamicMatrix<float> &);
+template size_t utils::calcFingerprint(const blaze::DynamicMatrix<double> &);
+template size_t utils::calcFingerprint(const blaze::CompressedMatrix<float> &);
+template size_t utils::calcFingerprint(const blaze::CompressedMatrix<double> &);
@@ -0,0 +1,68 @@
+#include <utils/logging.hpp>
+
+using namespace utils;
+
+namespace
+{
+    std::mutex logMutex;
+    std::shared_ptr<ILogSink> logSink = std::make_shared<StdoutLogSink>();
+    LogLevel logLevel = static_cast<LogLevel>(KMEANS_LOG_LEVEL);
+}
+
+void
+StdoutLogSink::write(LogLevel /*level*/, const std::string &message)
+{
+    std::fwrite(message.data(), 1, message.size(), stdout);
+    std::fputc('\n', stdout);
+}
+
+void
+utils::setLogSink(std::shared_ptr<ILogSink> sink)
+{
+    std::lock_guard<std::mutex> lock(logMutex);
+    logSink = sink;
+}
+
+void
+utils::setLogLevel(LogLevel level)
+{
+    std::lock_guard<std::mutex> lock(logMutex);
+    logLevel = level;
+}
+
+bool
+utils::isLogEnabled(LogLevel level)
+{
+    std::lock_guard<std::mutex> lock(logMutex);
+    return level != LogLevel::Off && level >= logLevel && logSink != nullptr;
+}
+
+void
+utils::log(LogLevel level, const char *format, ...)
+{
+    if (!isLogEnabled(level))
+    {
+        return;
+    }
+
+    va_list args;
+    va_start(args, format);
+    va_list argsCopy;
+    va_copy(argsCopy, args);
+    const int length = std::vsnprintf(nullptr, 0, format, argsCopy);
+    va_end(argsCopy);
+
+    std::string message(length > 0 ? static_cast<size_t>(length) : 0, '\0');
+    if (length > 0)
+    {
+        // The buffer of a std::string is contiguous and has room for the terminating null.
+        std::vsnprintf(&message[0], message.size() + 1, format, args);
+    }
+    va_end(args);
+
+    std::lock_guard<std::mutex> lock(logMutex);
+    if (logSink != nullptr)
+    {
+        logSink->write(level, message);
+    }
+}
@@ -0,0 +1,208 @@
+#include <utils/parallel.hpp>
+
+using namespace utils;
+
+namespace
+{
+    /**
+     * Worker threads which are kept alive between parallel loops, so a loop does not pay for creating its threads.
+     */
+    class ThreadPool
+    {
+    public:
+        ~ThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                isStopping = true;
+            }
+            hasTasks.notify_all();
+            for (auto &worker : workers)
+            {
+                worker.join();
+            }
+        }
+
+        /**
+         * Queues `numCopies` runs of `task`. Every queued task gets a thread of its own, so the pool grows to the
+         * largest number of tasks which were running or waiting at the same time.
+         */
+        void
+        submit(size_t numCopies, const std::function<void()> &task)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                for (size_t i = 0; i < numCopies; i++)
+                {
+                    tasks.push_back(task);
+                }
+                while (workers.size() < numBusy + tasks.size())
+                {
+                    workers.emplace_back([this]()
+                                         { work(); });
+                }
+            }
+            hasTasks.notify_all();
+        }
+
+    private:
+        void
+        work()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true)
+            {
+                hasTasks.wait(lock, [this]()
+                              { return isStopping || !tasks.empty(); });
+                if (tasks.empty())
+                {
+                    return;
+                }
+
+                auto task = std::move(tasks.front());
+                tasks.pop_front();
+                numBusy++;
+                lock.unlock();
+                task();
+                lock.lock();
+                numBusy--;
+            }
+        }
+
+        std::mutex mutex;
+        std::condition_variable hasTasks;
+        std::deque<std::function<void()>> tasks;
+        std::vector<std::thread> workers;
+        size_t numBusy = 0;
+        bool isStopping = false;
+    };
+
+    ThreadPool &
+    getThreadPool()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    /**
+     * The progress of one call to `parallelForPartitions`, shared with the pool tasks which may outlive the call.
+     */
+    struct PartitionedLoop
+    {
+        std::atomic<size_t> nextPartition{0};
+        std::atomic<size_t> numFinished{0};
+        std::atomic<bool> hasFailed{false};
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable isFinished;
+    };
+}
+
+size_t
+utils::resolveNumberOfThreads(size_t numThreads)
+{
+    if (numThreads == 0)
+    {
+        return std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    return numThreads;
+}
+
+void
+utils::parallelForPartitions(size_t begin, size_t end, size_t numPartitions, size_t numThreads,
+                             const std::function<void(size_t, size_t, size_t)> &body)
+{
+    if (end <= begin || numPartitions == 0)
+    {
+        return;
+    }
+
+    const size_t size = end - begin;
+    auto partitionBegin = [begin, size, numPartitions](size_t partition)
+    {
+        return begin + (size * partition) / numPartitions;
+    };
+
+    // Threads pick the next unprocessed partition so uneven partitions are balanced. After the first
+    // exception the remaining partitions are only counted as finished, and the exception is rethrown
+    // on the calling thread once every partition is accounted for.
+    auto loop = std::make_shared<PartitionedLoop>();
+    auto fail = [loop]()
+    {
+        std::lock_guard<std::mutex> lock(loop->mutex);
+        if (loop->error == nullptr)
+        {
+            loop->error = std::current_exception();
+        }
+        loop->hasFailed = true;
+    };
+
+    // Pool tasks which start after the loop has finished find no partition left and never touch `body`.
+    auto worker = [loop, fail, numPartitions, partitionBegin, &body]()
+    {
+        for (size_t partition = loop->nextPartition++; partition < numPartitions; partition = loop->nextPartition++)
+        {
+            if (!loop->hasFailed)
+            {
+                try
+                {
+                    body(partition, partitionBegin(partition), partitionBegin(partition + 1));
+                }
+                catch (...)
+                {
+                    fail();
+                }
+            }
+
+            if (++loop->numFinished == numPartitions)
+            {
+                std::lock_guard<std::mutex> lock(loop->mutex);
+                loop->isFinished.notify_all();
+            }
+        }
+    };
+
+    const size_t nThreads = std::min(resolveNumberOfThreads(numThreads), numPartitions);
+    if (nThreads > 1)
+    {
+        try
+        {
+            getThreadPool().submit(nThreads - 1, worker);
+        }
+        catch (...)
+        {
+            // The tasks which were queued still finish the partitions they pick.
+            fail();
+        }
+    }
+
+    // The calling thread does its share of the work as well, so nested loops make progress even when
+    // every pool thread is busy.
+    worker();
+
+    std::unique_lock<std::mutex> lock(loop->mutex);
+    loop->isFinished.wait(lock, [&loop, numPartitions]()
+                          { return loop->numFinished == numPartitions; });
+
+    if (loop->error != nullptr)
+    {
+        std::rethrow_exception(loop->error);
+    }
+}
+
+void
+utils::parallelFor(size_t begin, size_t end, size_t numThreads, const std::function<void(size_t, size_t)> &body)
+{
+    const size_t nThreads = resolveNumberOfThreads(numThreads);
+    if (nThreads == 1)
+    {
+        body(begin, end);
+        return;
+    }
+
+    // Use a few chunks per thread so threads that finish early can help out.
+    const size_t chunksPerThread = 4;
+    const size_t numChunks = std::min(end - begin, nThreads * chunksPerThread);
+    parallelForPartitions(begin, end, numChunks, nThreads, [&body](size_t, size_t chunkBegin, size_t chunkEnd)
+                          { body(chunkBegin, chunkEnd); });
+}
@@ -41,6 +41,32 @@ Random::Random(int fixedSeed)
     }
 }
 
+Random::Random(int fixedSeed, size_t streamIndex) : Random(fixedSeed)
+{
+    if (fixedSeed != -1 && streamIndex != 0)
+    {
+        // Mix the stream index into the seed so the streams are not shifted copies of each other.
+        std::seed_seq randomSeq{static_cast<uint>(fixedSeed), static_cast<uint>(streamIndex), static_cast<uint>(streamIndex >> 32)};
+        randomEngine.seed(randomSeq);
+    }
+}
+
+std::string
+Random::getState() const
+{
+    std::ostringstream stream;
+    stream << randomEngine;
+    return stream.str();
+}
+
+void
+Random::setState(const std::string &state)
+{
+    std::istringstream stream(state);
+    stream >> randomEngine;
+    pickRandomValue.reset();
+}
+
 std::shared_ptr<blaze::DynamicVector<size_t>>
 Random::runWeightedReservoirSampling(const size_t k, const size_t n, blaze::DynamicVector<size_t> weights)
 {
@@ -107,6 +133,12 @@ Random::choice(blaze::DynamicVector<double> weights)
     return pickedIndex;
 }
 
+size_t
+Random::choice(const WeightedSampler &sampler)
+{
+    return sampler.find(this->getDouble() * sampler.getTotalWeight());
+}
+
 size_t
 Random::stochasticRounding(double value)
 {
@@ -120,3 +152,101 @@ Random::stochasticRounding(double value)
     }
     return static_cast<size_t>(round(valueLow)); // Round down
 }
+
+WeightedSampler::WeightedSampler(size_t n) : weights(n, 0.0), tree(n + 1, 0.0)
+{
+}
+
+WeightedSampler::WeightedSampler(const blaze::DynamicVector<double> &w) : weights(w.size()), tree(w.size() + 1)
+{
+    rebuild(w);
+}
+
+void
+WeightedSampler::rebuild(const blaze::DynamicVector<double> &w)
+{
+    assert(w.size() == weights.size());
+
+    const size_t n = weights.size();
+    std::fill(tree.begin(), tree.end(), 0.0);
+
+    for (size_t i = 1; i <= n; i++)
+    {
+        weights[i - 1] = w[i - 1];
+        tree[i] += w[i - 1];
+
+        // Push the partial sum to the parent node.
+        const size_t parent = i + (i & (~i + 1));
+        if (parent <= n)
+        {
+            tree[parent] += tree[i];
+        }
+    }
+}
+
+void
+WeightedSampler::update(size_t index, double weight)
+{
+    const double delta = weight - weights[index];
+    weights[index] = weight;
+
+    for (size_t i = index + 1; i < tree.size(); i += (i & (~i + 1)))
+    {
+        tree[i] += delta;
+    }
+}
+
+size_t
+WeightedSampler::find(double target) const
+{
+    const size_t n = weights.size();
+
+    size_t step = 1;
+    while (step * 2 <= n)
+    {
+        step *= 2;
+    }
+
+    // Descend the tree to find the last node whose prefix sum is at most the target.
+    size_t position = 0;
+    for (; step > 0; step /= 2)
+    {
+        const size_t next = position + step;
+        if (next <= n && tree[next] <= target)
+        {
+            position = next;
+            target -= tree[next];
+        }
+    }
+
+    // Rounding errors could leave the position past the last index or on a zero weight.
+    size_t index = std::min(position, n - 1);
+    while (index > 0 && weights[index] <= 0.0)
+    {
+        index--;
+    }
+    return index;
+}
+
+double
+WeightedSampler::getWeight(size_t index) const
+{
+    return weights[index];
+}
+
+double
+WeightedSampler::getTotalWeight() const
+{
+    double total = 0.0;
+    for (size_t i = weights.size(); i > 0; i -= (i & (~i + 1)))
+    {
+        total += tree[i];
+    }
+    return total;
+}
+
+size_t
+WeightedSampler::size() const
+{
+    return weights.size();
+}
@@ -162,10 +162,13 @@ int main() {
   // auto parser = CovertypeParser();
   // auto parsedData = parser.parse("data/raw/covtype.data.gz");
 
+  // auto parser = BagOfWordsParser();
+  // auto parsedData = parser.parseSparse("data/raw/docword.enron.txt.gz");
+
   auto parser = TowerParser();
   auto parsedData = parser.parse("data/raw/Tower.txt");
 
-  printf("Data loading completed!\n");
+  KMEANS_LOG_INFO("Data loading completed!");
   
   KMeans kMeansAlg(10, true, false, 100U, 0.0001);
   auto result = kMeansAlg.run(*parsedData);